@@ -0,0 +1,71 @@
+// Replaces the global allocation functions to count heap allocations.
+// Only linked into the benchmark executable.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "Bench.h"
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations{0};
+
+    void* allocate(size_t n)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void* p = std::malloc(n ? n : 1)) return p;
+        throw std::bad_alloc();
+    }
+
+    void* allocateAligned(size_t n, std::align_val_t al)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        const size_t align = std::max(size_t(al), sizeof(void*));
+#if defined(_WIN32)
+        if (void* p = _aligned_malloc(n ? n : 1, align)) return p;
+#else
+        void* p = nullptr;
+        if (posix_memalign(&p, align, n ? n : 1) == 0) return p;
+#endif
+        throw std::bad_alloc();
+    }
+
+    void freeAligned(void* p)
+    {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+uint64_t bench::allocationCount()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t n) { return allocate(n); }
+void* operator new[](size_t n) { return allocate(n); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept
+{
+    try { return allocate(n); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t n, const std::nothrow_t&) noexcept
+{
+    try { return allocate(n); } catch (...) { return nullptr; }
+}
+void* operator new(size_t n, std::align_val_t al) { return allocateAligned(n, al); }
+void* operator new[](size_t n, std::align_val_t al) { return allocateAligned(n, al); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { freeAligned(p); }
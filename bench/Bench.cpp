@@ -0,0 +1,238 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <regex>
+#include <thread>
+
+#include "core/geo/PointKernels.h"
+
+namespace bench
+{
+    namespace
+    {
+        struct Entry
+        {
+            std::string name;
+            Fn fn;
+            int64_t arg;
+        };
+
+        std::vector<Entry>& registry()
+        {
+            static std::vector<Entry> r;
+            return r;
+        }
+
+        struct Result
+        {
+            std::string name;
+            std::string label;
+            uint64_t iterations = 0;
+            double nsPerIter = 0;
+            double itemsPerSec = 0;
+            double allocsPerIter = 0;
+        };
+
+        std::string formatTime(double ns)
+        {
+            char buf[32];
+            if (ns < 1e3) std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+            else if (ns < 1e6) std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+            else if (ns < 1e9) std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+            else std::snprintf(buf, sizeof(buf), "%.3f s", ns / 1e9);
+            return buf;
+        }
+
+        std::string formatRate(double perSec)
+        {
+            char buf[32];
+            if (perSec >= 1e9) std::snprintf(buf, sizeof(buf), "%.2fG/s", perSec / 1e9);
+            else if (perSec >= 1e6) std::snprintf(buf, sizeof(buf), "%.2fM/s", perSec / 1e6);
+            else if (perSec >= 1e3) std::snprintf(buf, sizeof(buf), "%.2fk/s", perSec / 1e3);
+            else std::snprintf(buf, sizeof(buf), "%.2f/s", perSec);
+            return buf;
+        }
+
+        std::string jsonEscape(const std::string& s)
+        {
+            std::string out;
+            for (char c : s)
+            {
+                if (c == '"' || c == '\\') out += '\\';
+                out += c;
+            }
+            return out;
+        }
+
+        bool writeJson(const std::string& path, const std::vector<Result>& results)
+        {
+            std::ofstream os(path);
+            if (!os) return false;
+
+            char date[64] = {};
+            const std::time_t now = std::time(nullptr);
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+            os << "{\n  \"context\": {\n"
+               << "    \"date\": \"" << date << "\",\n"
+               << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+               << "    \"point_kernel_isa\": \"" << pointKernelIsa() << "\"\n"
+               << "  },\n  \"benchmarks\": [\n";
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                const Result& r = results[i];
+                char buf[256];
+                std::snprintf(buf, sizeof(buf),
+                              "\"iterations\": %llu, \"real_time\": %.3f, \"time_unit\": \"ns\", "
+                              "\"items_per_second\": %.3f, \"allocs_per_iteration\": %.3f",
+                              (unsigned long long)r.iterations, r.nsPerIter, r.itemsPerSec, r.allocsPerIter);
+                os << "    {\"name\": \"" << jsonEscape(r.name) << "\", " << buf;
+                if (!r.label.empty()) os << ", \"label\": \"" << jsonEscape(r.label) << "\"";
+                os << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+            }
+            os << "  ]\n}\n";
+            return bool(os);
+        }
+    }
+
+    bool State::keepRunning()
+    {
+        if (!m_started)
+        {
+            m_started = true;
+            m_allocStart = allocationCount();
+            m_start = Clock::now();
+        }
+        if (m_done == m_iterations)
+        {
+            if (!m_paused) pauseTiming();
+            return false;
+        }
+        ++m_done;
+        return true;
+    }
+
+    void State::pauseTiming()
+    {
+        m_elapsed += Clock::now() - m_start;
+        m_allocs += allocationCount() - m_allocStart;
+        m_paused = true;
+    }
+
+    void State::resumeTiming()
+    {
+        m_paused = false;
+        m_allocStart = allocationCount();
+        m_start = Clock::now();
+    }
+
+    struct Runner
+    {
+        // Grows the iteration count until one run takes at least minTime.
+        static Result run(const Entry& e, double minTime)
+        {
+            uint64_t iters = 1;
+            for (;;)
+            {
+                State s(e.arg, iters);
+                e.fn(s);
+                const double secs = std::chrono::duration<double>(s.m_elapsed).count();
+
+                if (secs >= minTime || iters >= 1000000000ull)
+                {
+                    Result r;
+                    r.name = e.name;
+                    r.label = s.m_label;
+                    r.iterations = iters;
+                    r.nsPerIter = secs * 1e9 / double(iters);
+                    r.itemsPerSec = secs > 0 ? double(s.m_items) / secs : 0.0;
+                    r.allocsPerIter = double(s.m_allocs) / double(iters);
+                    return r;
+                }
+
+                // like Google Benchmark: aim 40% past the target, at most 10x per step
+                double mult = secs > 0 ? minTime * 1.4 / secs : 10.0;
+                if (secs / minTime <= 0.1) mult = std::min(mult, 10.0);
+                iters = std::max(iters + 1, uint64_t(double(iters) * mult));
+            }
+        }
+    };
+
+    void add(std::string name, Fn fn, std::vector<int64_t> args)
+    {
+        if (args.empty())
+        {
+            registry().push_back({std::move(name), std::move(fn), 0});
+            return;
+        }
+        for (int64_t a : args)
+            registry().push_back({name + "/" + std::to_string(a), fn, a});
+    }
+
+    int runAll(int argc, char** argv)
+    {
+        std::string filter = ".";
+        std::string jsonPath;
+        double minTime = 0.5;
+        bool list = false;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string a = argv[i];
+            auto value = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                {
+                    std::fprintf(stderr, "%s needs a value\n", a.c_str());
+                    std::exit(2);
+                }
+                return argv[++i];
+            };
+
+            if (a == "--filter") filter = value();
+            else if (a == "--json") jsonPath = value();
+            else if (a == "--min-time") minTime = std::atof(value().c_str());
+            else if (a == "--list") list = true;
+            else
+            {
+                std::fprintf(stderr,
+                    "usage: %s [--filter REGEX] [--min-time SECONDS] [--json FILE] [--list]\n", argv[0]);
+                return a == "-h" || a == "--help" ? 0 : 2;
+            }
+        }
+
+        const std::regex re(filter);
+        std::vector<Result> results;
+
+        if (!list)
+            std::printf("%-40s %14s %12s %12s %12s\n", "benchmark", "time/iter", "iterations", "items/s", "allocs/iter");
+
+        for (const Entry& e : registry())
+        {
+            if (!std::regex_search(e.name, re)) continue;
+            if (list)
+            {
+                std::printf("%s\n", e.name.c_str());
+                continue;
+            }
+
+            const Result r = Runner::run(e, minTime);
+            std::printf("%-40s %14s %12llu %12s %12.1f %s\n", r.name.c_str(), formatTime(r.nsPerIter).c_str(),
+                        (unsigned long long)r.iterations, r.itemsPerSec > 0 ? formatRate(r.itemsPerSec).c_str() : "-",
+                        r.allocsPerIter, r.label.c_str());
+            std::fflush(stdout);
+            results.push_back(r);
+        }
+
+        if (!jsonPath.empty() && !writeJson(jsonPath, results))
+        {
+            std::fprintf(stderr, "failed to write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        return 0;
+    }
+}
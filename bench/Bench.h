@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal Google-Benchmark-style harness: register a function, the runner
+// grows the iteration count until a run lasts --min-time, then reports time
+// per iteration, items/s and heap allocations per iteration.
+namespace bench
+{
+    // Heap allocations made so far by this process (see AllocCounter.cpp).
+    uint64_t allocationCount();
+
+    class State
+    {
+    public:
+        State(int64_t arg, uint64_t iterations) : m_arg(arg), m_iterations(iterations) {}
+
+        // while (state.keepRunning()) { ...measured code... }
+        bool keepRunning();
+
+        int64_t arg() const { return m_arg; }
+        uint64_t iterations() const { return m_iterations; }
+
+        // Exclude per-iteration setup (e.g. clearing a cache) from the timing.
+        void pauseTiming();
+        void resumeTiming();
+
+        // Totals over all iterations.
+        void setItemsProcessed(uint64_t items) { m_items = items; }
+        void setLabel(std::string label) { m_label = std::move(label); }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        int64_t m_arg;
+        uint64_t m_iterations;
+        uint64_t m_done = 0;
+        bool m_started = false;
+        bool m_paused = false;
+
+        Clock::time_point m_start;
+        Clock::duration m_elapsed{};
+        uint64_t m_allocStart = 0;
+        uint64_t m_allocs = 0;
+        uint64_t m_items = 0;
+        std::string m_label;
+
+        friend struct Runner;
+    };
+
+    using Fn = std::function<void(State&)>;
+
+    // Registers name/<arg> for each arg (or just name when args is empty).
+    void add(std::string name, Fn fn, std::vector<int64_t> args = {});
+
+    // Runs everything matching --filter; returns the process exit code.
+    int runAll(int argc, char** argv);
+
+    // Keeps the optimiser from discarding a computed value.
+    template <class T> inline void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+}
@@ -0,0 +1,286 @@
+// Cook engine benchmarks. Sizes are point counts (SOPs) or node counts (graphs).
+//
+//   hypersphere_bench --filter Transform --json transform.json
+
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <sstream>
+
+#include "Bench.h"
+
+#include "core/eval/Cooker.h"
+#include "core/graph/Graph.h"
+#include "core/graph/GraphIO.h"
+#include "core/graph/NodeRegistry.h"
+#include "core/ops/Builtins.h"
+#include "core/ops/GridSop.h"
+#include "core/ops/MergeSop.h"
+#include "core/ops/NullSop.h"
+#include "core/ops/TransformSop.h"
+#include "core/ops/WaveSop.h"
+#include "core/util/ThreadPool.h"
+
+namespace
+{
+    const std::vector<int64_t> kPointCounts = {1000, 10000, 100000, 1000000, 10000000};
+    const std::vector<int64_t> kNodeCounts = {10, 100, 1000, 10000, 100000};
+    const std::vector<int64_t> kFrameCounts = {24, 240, 2400};
+
+    ThreadPool& pool()
+    {
+        static ThreadPool p;
+        return p;
+    }
+
+    CookContext parallelContext()
+    {
+        CookContext ctx;
+        ctx.pool = &pool();
+        return ctx;
+    }
+
+    void setPointCount(GridSop& g, int64_t points)
+    {
+        const int side = std::max(2, int(std::lround(std::sqrt(double(points)))));
+        g.params().setInt(GridSop::Rows, side);
+        g.params().setInt(GridSop::Cols, side);
+    }
+
+    std::shared_ptr<const Geometry> makeGrid(int64_t points)
+    {
+        GridSop g(1);
+        setPointCount(g, points);
+        return std::make_shared<const Geometry>(g.cook(parallelContext(), {}));
+    }
+
+    void gridCook(bench::State& state)
+    {
+        GridSop g(1);
+        setPointCount(g, state.arg());
+        const CookContext ctx = parallelContext();
+
+        size_t points = 0;
+        while (state.keepRunning())
+        {
+            Geometry out = g.cook(ctx, {});
+            points = out.numPoints();
+            bench::doNotOptimize(out);
+        }
+        state.setItemsProcessed(points * state.iterations());
+    }
+
+    void transformCook(bench::State& state)
+    {
+        const std::vector<std::shared_ptr<const Geometry>> inputs = {makeGrid(state.arg())};
+        TransformSop xf(2);
+        xf.params().setVec3(TransformSop::Translate, {0.5f, 1.0f, -2.0f});
+        xf.params().setVec3(TransformSop::Rotate, {15.0f, 30.0f, 45.0f});
+        xf.params().setVec3(TransformSop::Scale, {2.0f, 1.0f, 0.5f});
+        const CookContext ctx = parallelContext();
+
+        while (state.keepRunning())
+        {
+            Geometry out = xf.cook(ctx, inputs);
+            bench::doNotOptimize(out);
+        }
+        state.setItemsProcessed(inputs[0]->numPoints() * state.iterations());
+    }
+
+    void mergeCook(bench::State& state)
+    {
+        auto half = makeGrid(state.arg() / 2);
+        const std::vector<std::shared_ptr<const Geometry>> inputs = {half, half};
+        MergeSop merge(3);
+        const CookContext ctx = parallelContext();
+
+        while (state.keepRunning())
+        {
+            Geometry out = merge.cook(ctx, inputs);
+            bench::doNotOptimize(out);
+        }
+        state.setItemsProcessed(2 * half->numPoints() * state.iterations());
+    }
+
+    // grid -> transform -> null, evaluated through the cooker
+    struct Chain
+    {
+        Graph graph;
+        NodeId out = 3;
+
+        explicit Chain(int64_t points)
+        {
+            auto grid = std::make_unique<GridSop>(1);
+            setPointCount(*grid, points);
+            auto xf = std::make_unique<TransformSop>(2);
+            xf->params().setVec3(TransformSop::Rotate, {0.0f, 45.0f, 0.0f});
+            graph.addNode(std::move(grid));
+            graph.addNode(std::move(xf));
+            graph.addNode(std::make_unique<NullSop>(3));
+            graph.connect(1, 2, 0);
+            graph.connect(2, 3, 0);
+        }
+    };
+
+    void evaluateCold(bench::State& state)
+    {
+        Chain chain(state.arg());
+        Cooker cooker(&chain.graph, CookMode::Parallel);
+
+        size_t points = 0;
+        while (state.keepRunning())
+        {
+            auto geo = cooker.evaluate(chain.out);
+            points = geo->numPoints();
+
+            state.pauseTiming();
+            geo.reset();
+            cooker.clearCache();
+            state.resumeTiming();
+        }
+        state.setItemsProcessed(points * state.iterations());
+    }
+
+    void evaluateWarm(bench::State& state)
+    {
+        Chain chain(state.arg());
+        Cooker cooker(&chain.graph, CookMode::Parallel);
+        cooker.evaluate(chain.out);
+
+        // A hit touches no points: count evaluations, not geometry.
+        while (state.keepRunning())
+            bench::doNotOptimize(cooker.evaluate(chain.out));
+        state.setItemsProcessed(state.iterations());
+        state.setLabel("evaluations");
+    }
+
+    // Synthetic network of about `nodes` nodes: a tiny grid fanned out into a
+    // random tree of Null/Transform branches, whose leaves are then reduced
+    // pairwise by Merges. Fan-out and fan-in without the geometry blowing up.
+    // Returns the final Merge.
+    NodeId buildSyntheticGraph(Graph& g, int64_t nodes)
+    {
+        auto grid = std::make_unique<GridSop>(1);
+        grid->params().setInt(GridSop::Rows, 2);
+        grid->params().setInt(GridSop::Cols, 2);
+        g.addNode(std::move(grid));
+
+        uint32_t rng = 12345;
+        auto next = [&rng]() { rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+
+        const NodeId branches = NodeId(std::max<int64_t>(2, nodes / 2));
+        std::deque<NodeId> open = {1};
+        for (NodeId id = 2; id <= branches; ++id)
+        {
+            if (id % 2) g.addNode(std::make_unique<NullSop>(id));
+            else g.addNode(std::make_unique<TransformSop>(id));
+            g.connect(1 + next() % (id - 1), id, 0);
+            open.push_back(id);
+        }
+
+        NodeId id = branches;
+        while (open.size() > 1)
+        {
+            g.addNode(std::make_unique<MergeSop>(++id));
+            g.connect(open[0], id, 0);
+            g.connect(open[1], id, 1);
+            open.pop_front();
+            open.pop_front();
+            open.push_back(id);
+        }
+        return id;
+    }
+
+    void graphInputsOf(bench::State& state)
+    {
+        Graph g;
+        buildSyntheticGraph(g, state.arg());
+        const auto ids = g.allNodeIds();
+
+        while (state.keepRunning())
+            for (NodeId id : ids)
+                bench::doNotOptimize(g.inputsOf(id));
+        state.setItemsProcessed(ids.size() * state.iterations());
+    }
+
+    // Whole-graph load from memory, so it's parsing and construction only.
+    void graphLoad(bench::State& state, bool binary)
+    {
+        NodeRegistry registry;
+        registerBuiltinSops(registry);
+
+        Graph g;
+        buildSyntheticGraph(g, state.arg());
+        std::ostringstream os;
+        if (binary) saveGraphBinary(os, g);
+        else saveGraphText(os, g);
+        const std::string bytes = os.str();
+
+        std::string error;
+        while (state.keepRunning())
+        {
+            Graph loaded;
+            const bool ok = binary ? loadGraphBinary(bytes.data(), bytes.size(), registry, loaded, error)
+                                   : [&]() { std::istringstream is(bytes); return loadGraphText(is, registry, loaded, error); }();
+            bench::doNotOptimize(ok);
+            state.pauseTiming(); // don't time the teardown
+            loaded = Graph();
+            state.resumeTiming();
+        }
+        state.setItemsProcessed(g.nodeCount() * state.iterations());
+    }
+
+    void graphLoadBinary(bench::State& state) { graphLoad(state, true); }
+    void graphLoadText(bench::State& state) { graphLoad(state, false); }
+
+    // Keying and plan overhead of a fully cached network.
+    void evaluateWarmGraph(bench::State& state)
+    {
+        Graph g;
+        const NodeId root = buildSyntheticGraph(g, state.arg());
+
+        Cooker cooker(&g, CookMode::Parallel);
+        cooker.evaluate(root);
+
+        while (state.keepRunning())
+            bench::doNotOptimize(cooker.evaluate(root));
+        state.setItemsProcessed(state.iterations());
+        state.setLabel("evaluations");
+    }
+
+    // A frame range over grid -> transform -> wave: the static part is cooked
+    // once, the wave once per frame.
+    void cookFrames(bench::State& state)
+    {
+        Graph g;
+        auto grid = std::make_unique<GridSop>(1);
+        setPointCount(*grid, 100000);
+        g.addNode(std::move(grid));
+        g.addNode(std::make_unique<TransformSop>(2));
+        g.addNode(std::make_unique<WaveSop>(3));
+        g.connect(1, 2, 0);
+        g.connect(2, 3, 0);
+
+        Cooker cooker(&g, CookMode::Parallel);
+        const int frames = int(state.arg());
+        while (state.keepRunning())
+            cooker.cookFrames(3, 1, frames, [](int, std::shared_ptr<const Geometry> geo) { bench::doNotOptimize(geo); });
+        state.setItemsProcessed(size_t(frames) * state.iterations());
+        state.setLabel("frames");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::add("GridSop/cook", gridCook, kPointCounts);
+    bench::add("TransformSop/cook", transformCook, kPointCounts);
+    bench::add("MergeSop/cook", mergeCook, kPointCounts);
+    bench::add("Cooker/evaluate_cold", evaluateCold, kPointCounts);
+    bench::add("Cooker/evaluate_warm", evaluateWarm, kPointCounts);
+    bench::add("Cooker/evaluate_warm_graph", evaluateWarmGraph, kNodeCounts);
+    bench::add("Cooker/cook_frames", cookFrames, kFrameCounts);
+    bench::add("Graph/inputsOf", graphInputsOf, kNodeCounts);
+    bench::add("Graph/load_binary", graphLoadBinary, kNodeCounts);
+    bench::add("Graph/load_text", graphLoadText, kNodeCounts);
+    return bench::runAll(argc, argv);
+}
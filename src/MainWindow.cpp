@@ -6,31 +6,68 @@
 #include <QAction>
 #include <QVBoxLayout>
 #include <QMessageBox>
+#include <QStatusBar>
 #include <QTimer>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <algorithm>
+#include <vector>
 
 #include "ViewportWidget.h"
 #include "ParamPanel.h"
+#include "TimelineWidget.h"
 
-#include "core/ops/GridSop.h"
-#include "core/ops/TransformSop.h"
-#include "core/ops/MergeSop.h"
-#include "core/ops/NullSop.h"
+#include "core/eval/DiskCache.h"
+#include "core/graph/GraphIO.h"
+#include "core/ops/Builtins.h"
+#include "core/util/Profiler.h"
 
 #include "ui/NodeGraphView.h"
 
 MainWindow::MainWindow()
   : QMainWindow()
-  , m_cooker(&m_graph)
+  , m_cooker(&m_graph, CookMode::Parallel)
 {
   setupRegistry();
 
-  // Layout: viewport on the left, graph + params stacked on the right
+  // Cap cooked geometry held in memory; HYPERSPHERE_CACHE_MB overrides (0 = unlimited).
+  bool budgetSet = false;
+  const int cacheMb = qEnvironmentVariableIntValue("HYPERSPHERE_CACHE_MB", &budgetSet);
+  m_cooker.setCacheBudget(size_t(budgetSet ? cacheMb : 2048) << 20);
+
+  // Slow cooks also go to disk so reopening a scene skips them.
+  // HYPERSPHERE_DISK_CACHE picks the directory ("off" disables it),
+  // HYPERSPHERE_DISK_CACHE_MB its size.
+  QString diskDir = qEnvironmentVariable("HYPERSPHERE_DISK_CACHE");
+  if (diskDir.isEmpty())
+    diskDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/cooks";
+  if (diskDir != "off")
+  {
+    DiskCacheOptions opts;
+    bool diskMbSet = false;
+    const int diskMb = qEnvironmentVariableIntValue("HYPERSPHERE_DISK_CACHE_MB", &diskMbSet);
+    if (diskMbSet) opts.maxBytes = size_t(diskMb) << 20;
+    auto disk = std::make_shared<DiskCache>(diskDir.toStdString(), opts);
+    if (disk->valid()) m_cooker.setDiskCache(std::move(disk));
+  }
+
+  // Layout: viewport over the timeline on the left, graph + params stacked on the right
   auto* splitter = new QSplitter(Qt::Horizontal, this);
 
   // left viewport
-  m_viewport = new ViewportWidget(splitter);
+  auto* left = new QWidget(splitter);
+  auto* leftLayout = new QVBoxLayout(left);
+  leftLayout->setContentsMargins(0, 0, 0, 0);
+  leftLayout->setSpacing(0);
+
+  m_viewport = new ViewportWidget(left);
   m_viewport->setMinimumWidth(250);
   m_viewport->setGraphAndCooker(&m_graph, &m_cooker);
+  leftLayout->addWidget(m_viewport, 1);
+
+  m_timeline = new TimelineWidget(left);
+  leftLayout->addWidget(m_timeline);
 
   // right side: vertical stack (params on top)
   auto* rightSplitter = new QSplitter(Qt::Vertical, splitter);
@@ -70,6 +107,8 @@ MainWindow::MainWindow()
   addActionFor("Transform");
   addActionFor("Merge");
   addActionFor("Null");
+  addActionFor("File");
+  addActionFor("Wave");
 
   tb->addSeparator();
 
@@ -88,6 +127,48 @@ MainWindow::MainWindow()
 
   QToolBar* toolbar = addToolBar("Graph");
 
+  const QString graphFilter = "Graphs (*.hsg *.hsgb);;Text graph (*.hsg);;Binary graph (*.hsgb)";
+  QAction* openAct = toolbar->addAction("Open...");
+  openAct->setShortcut(QKeySequence::Open);
+  connect(openAct, &QAction::triggered, this, [this, graphFilter]()
+  {
+    const QString path = QFileDialog::getOpenFileName(this, "Open Graph", QString(), graphFilter);
+    if (!path.isEmpty()) openGraph(path);
+  });
+
+  QAction* saveAct = toolbar->addAction("Save...");
+  saveAct->setShortcut(QKeySequence::Save);
+  connect(saveAct, &QAction::triggered, this, [this, graphFilter]()
+  {
+    const QString path = QFileDialog::getSaveFileName(this, "Save Graph", "untitled.hsg", graphFilter);
+    if (!path.isEmpty()) saveGraph(path);
+  });
+
+  // Chrome trace-event JSON of the cooks/frames recorded while this is on
+  // (open in chrome://tracing or Perfetto). Recording costs, so it's opt-in.
+  QAction* profileAct = toolbar->addAction("Record Profile");
+  profileAct->setCheckable(true);
+  connect(profileAct, &QAction::toggled, this, [this](bool on)
+  {
+    Profiler& prof = Profiler::instance();
+    if (on)
+    {
+      prof.clear();
+      prof.addUser();
+      statusBar()->showMessage("Recording profile; toggle again to save it", 3000);
+      return;
+    }
+    prof.removeUser();
+
+    const QString path = QFileDialog::getSaveFileName(this, "Save Profile", "hypersphere-trace.json",
+                                                      "Trace (*.json)");
+    if (path.isEmpty()) return;
+    if (!prof.writeChromeTrace(path.toStdString()))
+      QMessageBox::warning(this, "Error", "Could not write " + path);
+    else
+      statusBar()->showMessage("Profile saved to " + path, 3000);
+  });
+
   connect(m_graphView, &NodeGraphView::nodeSelected, this, [this](NodeId id){
     setSelected(id);
   });
@@ -96,14 +177,51 @@ MainWindow::MainWindow()
     setDisplay(id);
   });
 
-  connect(m_graphView, &NodeGraphView::graphChanged, this, [this](){
-    m_cooker.clearCache();
-    m_viewport->update();
+  connect(m_graphView, &NodeGraphView::graphAboutToChange, this, [this](){
+    m_cooker.interrupt();
+  });
+
+  connect(m_graphView, &NodeGraphView::graphChanged, this, [this](NodeId dst){
+    m_cooker.markDirty(dst);
+    m_viewport->requestCook();
+  });
+
+  connect(m_viewport, &ViewportWidget::cookProgress, this, [this](float f)
+  {
+    if (f < 1.0f)
+    {
+      statusBar()->showMessage(QString("Cooking... %1%").arg(int(f * 100.0f)));
+      return;
+    }
+
+    // Done: a failed node anywhere upstream explains an empty or odd result.
+    m_params->updateCookError();
+    for (NodeId id : m_graph.upstreamOf(m_displayNode))
+    {
+      const Node* n = m_graph.get(id);
+      const std::string error = n->cookError();
+      if (error.empty()) continue;
+      statusBar()->showMessage(QString::fromStdString(n->name() + ": " + error));
+      return;
+    }
+    statusBar()->clearMessage();
+  });
+
+  connect(m_params, &ParamPanel::paramsChanged, this, [this](bool preview)
+  {
+    m_viewport->requestCook(preview);
   });
 
-  connect(m_params, &ParamPanel::paramsChanged, this, [this]()
+  connect(m_timeline, &TimelineWidget::frameChanged, this, [this](int frame)
   {
-    m_viewport->update();
+    m_viewport->setFrame(frame, m_timeline->fps());
+    if (m_timeline->playing()) prefetchAhead();
+  });
+
+  connect(m_timeline, &TimelineWidget::playingChanged, this, [this](bool playing)
+  {
+    if (playing) prefetchAhead();
+    else m_cooker.stopPrefetch();
   });
 
   buildInitialGraph();
@@ -119,10 +237,7 @@ MainWindow::MainWindow()
 
 void MainWindow::setupRegistry()
 {
-  m_registry.registerType("Grid", [](NodeId id){ return std::make_unique<GridSop>(id); });
-  m_registry.registerType("Transform", [](NodeId id){ return std::make_unique<TransformSop>(id); });
-  m_registry.registerType("Merge", [](NodeId id){ return std::make_unique<MergeSop>(id); });
-  m_registry.registerType("Null", [](NodeId id){ return std::make_unique<NullSop>(id); });
+  registerBuiltinSops(m_registry);
 }
 
 NodeId MainWindow::spawn(const std::string& type)
@@ -138,8 +253,9 @@ NodeId MainWindow::spawn(const std::string& type)
   // Make unique-ish names
   node->setName(std::string(node->typeName()) + std::to_string(id));
 
+  // a fresh node has no outputs yet, so nothing cached can depend on it
+  m_cooker.interrupt();
   m_graph.addNode(std::move(node));
-  m_cooker.clearCache();
   if (m_graphView) m_graphView->rebuildFromGraph();
   return id;
 }
@@ -164,12 +280,50 @@ void MainWindow::buildInitialGraph()
     m_graphView->centerOnGraph();
   }
   m_cooker.clearCache();
-  if (m_viewport) m_viewport->update();
+  if (m_viewport) m_viewport->requestCook();
 
 
   m_displayNode = out;
 }
 
+void MainWindow::openGraph(const QString& path)
+{
+  // loading replaces the graph wholesale; nothing may be cooking from it
+  m_cooker.interrupt();
+
+  std::string error;
+  if (!loadGraphFile(path.toStdString(), m_registry, m_graph, error))
+  {
+    QMessageBox::warning(this, "Error", "Could not open " + path + ":\n" + QString::fromStdString(error));
+    return;
+  }
+
+  // node ids are reused across graphs: forget every memoised key
+  m_cooker.clearCache();
+
+  const auto ids = m_graph.allNodeIds();
+  m_nextId = ids.empty() ? 1 : ids.back() + 1;
+
+  // display the newest node nothing reads from
+  NodeId display = 0;
+  for (auto it = ids.rbegin(); it != ids.rend() && !display; ++it)
+    if (m_graph.outputsOf(*it).empty()) display = *it;
+
+  m_graphView->rebuildFromGraph();
+  m_graphView->centerOnGraph();
+  setSelected(display);
+  setDisplay(display);
+  setWindowTitle("Hypersphere - " + QFileInfo(path).fileName());
+}
+
+void MainWindow::saveGraph(const QString& path)
+{
+  if (!saveGraphFile(path.toStdString(), m_graph))
+    QMessageBox::warning(this, "Error", "Could not write " + path);
+  else
+    statusBar()->showMessage("Saved " + path, 3000);
+}
+
 void MainWindow::setSelected(NodeId id)
 {
   m_selectedNode = id;
@@ -181,8 +335,26 @@ void MainWindow::setSelected(NodeId id)
 void MainWindow::setDisplay(NodeId id)
 {
   m_displayNode = id;
-  m_viewport->setDisplayNode(id);
-  m_viewport->update();               // ⬅️ force redraw
+  m_viewport->setDisplayNode(id);     // kicks off a background cook
   if (m_graphView)
     m_graphView->setDisplayNode(id);
-}
\ No newline at end of file
+}
+
+void MainWindow::prefetchAhead()
+{
+  // About a second ahead of the playhead, wrapping like playback does. Edits
+  // interrupt the cooker (and so this); the next frame starts it again.
+  if (m_displayNode == 0) return;
+
+  const int start = m_timeline->startFrame();
+  const int length = m_timeline->endFrame() - start + 1;
+  const int ahead = std::min(length - 1, std::max(8, int(m_timeline->fps())));
+  if (ahead <= 0) return;
+
+  std::vector<int> frames;
+  frames.reserve(size_t(ahead));
+  for (int i = 1; i <= ahead; ++i)
+    frames.push_back(start + (m_timeline->frame() - start + i) % length);
+
+  m_cooker.prefetch(m_displayNode, std::move(frames), m_timeline->fps());
+}
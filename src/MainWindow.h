@@ -8,6 +8,7 @@
 class QListWidget;
 class ViewportWidget;
 class ParamPanel;
+class TimelineWidget;
 class NodeGraphView;
 
 class MainWindow final : public QMainWindow
@@ -28,11 +29,15 @@ private:
     NodeGraphView* m_graphView = nullptr;
     ViewportWidget* m_viewport = nullptr;
     ParamPanel* m_params = nullptr;
+    TimelineWidget* m_timeline = nullptr;
 
     void setupRegistry();
     void buildInitialGraph();
     NodeId spawn(const std::string& type);
+    void openGraph(const QString& path);
+    void saveGraph(const QString& path);
 
     void setSelected(NodeId id);
     void setDisplay(NodeId id);
+    void prefetchAhead();
 };
\ No newline at end of file
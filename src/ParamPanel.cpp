@@ -1,13 +1,22 @@
 #include "ParamPanel.h"
 
+#include <algorithm>
+
+#include <QComboBox>
 #include <QFormLayout>
+#include <QHBoxLayout>
 #include <QLabel>
 #include <QDoubleSpinBox>
+#include <QFileDialog>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QScreen>
 #include <QSpinBox>
+#include <QTimer>
 #include <QVBoxLayout>
 
-#include "core/ops/GridSop.h"
-#include "core/ops/TransformSop.h"
+#include "core/graph/Params.h"
 
 ParamPanel::ParamPanel(QWidget* parent)
   : QWidget(parent)
@@ -15,11 +24,27 @@ ParamPanel::ParamPanel(QWidget* parent)
   auto* root = new QVBoxLayout(this);
   m_form = new QFormLayout();
   root->addLayout(m_form);
+
+  m_error = new QLabel();
+  m_error->setWordWrap(true);
+  m_error->setStyleSheet("color: #e05050;");
+  m_error->hide();
+  root->addWidget(m_error);
   root->addStretch(1);
+
+  m_flushTimer = new QTimer(this);
+  m_flushTimer->setSingleShot(true);
+  connect(m_flushTimer, &QTimer::timeout, this, [this]() { flushEdits(true); });
+
+  m_settleTimer = new QTimer(this);
+  m_settleTimer->setSingleShot(true);
+  m_settleTimer->setInterval(250);
+  connect(m_settleTimer, &QTimer::timeout, this, &ParamPanel::settle);
 }
 
 void ParamPanel::setGraphAndCooker(Graph* g, Cooker* c)
 {
+  settle();
   m_graph = g;
   m_cooker = c;
   rebuild();
@@ -27,10 +52,85 @@ void ParamPanel::setGraphAndCooker(Graph* g, Cooker* c)
 
 void ParamPanel::setSelectedNode(NodeId id)
 {
+  settle(); // pending edits belong to the old node
   m_selected = id;
   rebuild();
 }
 
+void ParamPanel::queueEdit(size_t param, std::function<void(ParamSet&)> write, bool settleNow)
+{
+  m_pending[param] = std::move(write); // only the latest value of each parameter matters
+
+  if (settleNow)
+  {
+    settle();
+    return;
+  }
+
+  // At most one flush (and so one interrupt and one cook request) per
+  // display frame, however fast the widget ticks.
+  if (!m_flushTimer->isActive())
+  {
+    const qreal hz = screen() ? std::max<qreal>(screen()->refreshRate(), 30.0) : 60.0;
+    m_flushTimer->start(std::max(1, int(1000.0 / hz)));
+  }
+  m_settleTimer->start();
+}
+
+void ParamPanel::flushEdits(bool preview)
+{
+  if (m_pending.empty()) return;
+
+  Node* n = m_graph ? m_graph->get(m_selected) : nullptr;
+  if (!n)
+  {
+    m_pending.clear();
+    return;
+  }
+
+  if (m_cooker) m_cooker->interrupt(); // no cook may read params while we write them
+  for (auto& [param, write] : m_pending) write(n->params());
+  m_pending.clear();
+  // The cooker would see the new content anyway; this just drops its memo early.
+  if (m_cooker) m_cooker->markDirty(n->id());
+
+  m_previewShown = preview;
+  emit paramsChanged(preview);
+}
+
+void ParamPanel::settle()
+{
+  m_flushTimer->stop();
+  m_settleTimer->stop();
+
+  if (!m_pending.empty()) flushEdits(false);
+  else if (m_previewShown)
+  {
+    // the last preview already has the final values; just cook them in full
+    m_previewShown = false;
+    emit paramsChanged(false);
+  }
+}
+
+bool ParamPanel::eventFilter(QObject* watched, QEvent* e)
+{
+  // Releasing a spin box arrow (or a held arrow key) ends the scrub.
+  if (e->type() == QEvent::MouseButtonRelease
+      || (e->type() == QEvent::KeyRelease && !static_cast<QKeyEvent*>(e)->isAutoRepeat()))
+  {
+    if (m_settleTimer->isActive()) settle();
+  }
+  return QWidget::eventFilter(watched, e);
+}
+
+void ParamPanel::updateCookError()
+{
+  const Node* n = (m_graph && m_selected) ? m_graph->get(m_selected) : nullptr;
+  const QString error = n ? QString::fromStdString(n->cookError()) : QString();
+  m_error->setText(error);
+  m_error->setVisible(!error.isEmpty());
+}
+
 void ParamPanel::clearForm()
 {
   while (m_form->rowCount() > 0)
@@ -40,6 +140,7 @@ void ParamPanel::clearForm()
 void ParamPanel::rebuild()
 {
   clearForm();
+  updateCookError();
 
   if (!m_graph || m_selected == 0)
   {
@@ -56,71 +157,117 @@ void ParamPanel::rebuild()
 
   m_form->addRow(new QLabel(QString("Type: %1").arg(n->typeName())));
 
-  // Grid
-  if (auto* grid = dynamic_cast<GridSop*>(n))
+  const ParamLayout& layout = n->params().layout();
+  if (layout.size() == 0)
   {
-    auto* rows = new QSpinBox();
-    rows->setRange(2, 400);
-    rows->setValue(grid->rows);
-
-    auto* cols = new QSpinBox();
-    cols->setRange(2, 400);
-    cols->setValue(grid->cols);
-
-    auto* size = new QDoubleSpinBox();
-    size->setRange(0.01, 1000.0);
-    size->setDecimals(3);
-    size->setValue(grid->size);
-
-    auto apply = [this, grid, rows, cols, size]()
-    {
-      grid->rows = rows->value();
-      grid->cols = cols->value();
-      grid->size = float(size->value());
-      grid->bumpParamRevision();
-      if (m_cooker) m_cooker->clearCache();
-      emit paramsChanged();
-    };
-
-    connect(rows, &QSpinBox::valueChanged, this, [apply](int){ apply(); });
-    connect(cols, &QSpinBox::valueChanged, this, [apply](int){ apply(); });
-    connect(size, qOverload<double>(&QDoubleSpinBox::valueChanged), this, [apply](double){ apply(); });
-
-    m_form->addRow("Rows", rows);
-    m_form->addRow("Cols", cols);
-    m_form->addRow("Size", size);
+    m_form->addRow(new QLabel("No parameters."));
     return;
   }
 
-  // Transform
-  if (auto* xf = dynamic_cast<TransformSop*>(n))
+  // Every widget queues a write of only its own parameter (see queueEdit).
+  // Spin boxes report their release so a scrub settles without waiting.
+  auto spin = [this](const ParamDesc& d, double v)
   {
-    auto* tx = new QDoubleSpinBox(); tx->setRange(-1000, 1000); tx->setDecimals(3); tx->setValue(xf->translate.x);
-    auto* ty = new QDoubleSpinBox(); ty->setRange(-1000, 1000); ty->setDecimals(3); ty->setValue(xf->translate.y);
-    auto* tz = new QDoubleSpinBox(); tz->setRange(-1000, 1000); tz->setDecimals(3); tz->setValue(xf->translate.z);
+    auto* sb = new QDoubleSpinBox(); sb->setRange(d.min, d.max); sb->setDecimals(3); sb->setValue(v);
+    sb->installEventFilter(this);
+    return sb;
+  };
 
-    auto* sc = new QDoubleSpinBox(); sc->setRange(0.001, 1000); sc->setDecimals(3); sc->setValue(xf->uniformScale);
+  for (size_t i = 0; i < layout.size(); ++i)
+  {
+    const ParamDesc& d = layout[i];
+    const ParamSet& p = n->params();
 
-    auto apply = [this, xf, tx, ty, tz, sc]()
+    switch (d.type)
     {
-      xf->translate = { float(tx->value()), float(ty->value()), float(tz->value()) };
-      xf->uniformScale = float(sc->value());
-      xf->bumpParamRevision();
-      if (m_cooker) m_cooker->clearCache();
-      emit paramsChanged();
-    };
-
-    connect(tx, qOverload<double>(&QDoubleSpinBox::valueChanged), this, [apply](double){ apply(); });
-    connect(ty, qOverload<double>(&QDoubleSpinBox::valueChanged), this, [apply](double){ apply(); });
-    connect(tz, qOverload<double>(&QDoubleSpinBox::valueChanged), this, [apply](double){ apply(); });
-    connect(sc, qOverload<double>(&QDoubleSpinBox::valueChanged), this, [apply](double){ apply(); });
-
-    m_form->addRow("Translate X", tx);
-    m_form->addRow("Translate Y", ty);
-    m_form->addRow("Translate Z", tz);
-    m_form->addRow("Uniform Scale", sc);
-    return;
-  }
+      case ParamType::Int:
+      {
+        auto* sb = new QSpinBox();
+        sb->setRange(int(d.min), int(d.max));
+        sb->setValue(p.getInt(i));
+        sb->installEventFilter(this);
+        connect(sb, &QSpinBox::valueChanged, this, [this, i](int v)
+        {
+          queueEdit(i, [i, v](ParamSet& ps) { ps.setInt(i, v); });
+        });
+        m_form->addRow(d.label, sb);
+        break;
+      }
+      case ParamType::Float:
+      {
+        auto* sb = spin(d, p.getFloat(i));
+        connect(sb, qOverload<double>(&QDoubleSpinBox::valueChanged), this, [this, i](double v)
+        {
+          queueEdit(i, [i, v](ParamSet& ps) { ps.setFloat(i, float(v)); });
+        });
+        m_form->addRow(d.label, sb);
+        break;
+      }
+      case ParamType::Vec3:
+      {
+        // one row of X/Y/Z boxes
+        const Vec3 v = p.getVec3(i);
+        QDoubleSpinBox* boxes[3] = {spin(d, v.x), spin(d, v.y), spin(d, v.z)};
+        auto* row = new QWidget();
+        auto* h = new QHBoxLayout(row);
+        h->setContentsMargins(0, 0, 0, 0);
+        for (auto* b : boxes)
+        {
+          h->addWidget(b);
+          connect(b, qOverload<double>(&QDoubleSpinBox::valueChanged), this,
+                  [this, i, x = boxes[0], y = boxes[1], z = boxes[2]](double)
+          {
+            const Vec3 v{float(x->value()), float(y->value()), float(z->value())};
+            queueEdit(i, [i, v](ParamSet& ps) { ps.setVec3(i, v); });
+          });
+        }
+        m_form->addRow(d.label, row);
+        break;
+      }
+      case ParamType::Menu:
+      {
+        auto* combo = new QComboBox();
+        for (const char* item : d.items) combo->addItem(item);
+        combo->setCurrentIndex(p.getInt(i));
+        connect(combo, qOverload<int>(&QComboBox::currentIndexChanged), this, [this, i](int v)
+        {
+          queueEdit(i, [i, v](ParamSet& ps) { ps.setInt(i, v); }, true);
+        });
+        m_form->addRow(d.label, combo);
+        break;
+      }
+      case ParamType::String:
+      {
+        auto* line = new QLineEdit(QString::fromStdString(p.getString(i)));
+        auto apply = [this, i, line]()
+        {
+          queueEdit(i, [i, v = line->text().toStdString()](ParamSet& ps) { ps.setString(i, v); }, true);
+        };
+        connect(line, &QLineEdit::editingFinished, this, apply);
+
+        if (!d.fileFilter)
+        {
+          m_form->addRow(d.label, line);
+          break;
+        }
 
-  m_form->addRow(new QLabel("No editable parameters for this node yet."));
-}
\ No newline at end of file
+        auto* browse = new QPushButton("...");
+        connect(browse, &QPushButton::clicked, this, [this, line, apply, filter = d.fileFilter]()
+        {
+          const QString f = QFileDialog::getOpenFileName(this, "Open File", line->text(), filter);
+          if (f.isEmpty()) return;
+          line->setText(f);
+          apply();
+        });
+
+        auto* row = new QWidget();
+        auto* h = new QHBoxLayout(row);
+        h->setContentsMargins(0, 0, 0, 0);
+        h->addWidget(line, 1);
+        h->addWidget(browse);
+        m_form->addRow(d.label, row);
+        break;
+      }
+    }
+  }
+}
@@ -1,10 +1,14 @@
 #pragma once
 #include <QWidget>
+#include <functional>
+#include <map>
 
 #include "core/graph/Graph.h"
 #include "core/eval/Cooker.h"
 
 class QFormLayout;
+class QLabel;
+class QTimer;
 
 class ParamPanel final : public QWidget
 {
@@ -14,9 +18,13 @@ class ParamPanel final : public QWidget
 
     void setGraphAndCooker(Graph* g, Cooker* c);
     void setSelectedNode(NodeId id);
+    // Show why the selected node's last cook failed (after each cook).
+    void updateCookError();
 
     signals:
-      void paramsChanged(); // tell viewport to update
+      // tell viewport to update. preview: a control is still being scrubbed,
+      // a paramsChanged(false) follows once it settles.
+      void paramsChanged(bool preview);
 
 private:
     Graph* m_graph = nullptr;
@@ -24,6 +32,21 @@ private:
     NodeId m_selected = 0;
 
     QFormLayout* m_form = nullptr;
+    QLabel* m_error = nullptr; // selected node's cookError()
+
+    // Edits are coalesced: widgets queue the latest write per parameter and
+    // one flush per display frame applies them all under a single interrupt,
+    // as a preview cook. Once edits stop (or the control is released) the
+    // values are cooked at full resolution.
+    std::map<size_t, std::function<void(ParamSet&)>> m_pending;
+    QTimer* m_flushTimer = nullptr;
+    QTimer* m_settleTimer = nullptr;
+    bool m_previewShown = false; // the last cook requested was a preview
+
+    void queueEdit(size_t param, std::function<void(ParamSet&)> write, bool settleNow = false);
+    void flushEdits(bool preview);
+    void settle();
+    bool eventFilter(QObject* watched, QEvent* e) override;
 
     void rebuild();
     void clearForm();
@@ -0,0 +1,151 @@
+#include "TimelineWidget.h"
+
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QSignalBlocker>
+#include <QSlider>
+#include <QSpinBox>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+
+TimelineWidget::TimelineWidget(QWidget* parent)
+  : QWidget(parent)
+{
+  auto* h = new QHBoxLayout(this);
+  h->setContentsMargins(4, 2, 4, 2);
+
+  m_play = new QPushButton("Play");
+  m_play->setCheckable(true);
+  m_play->setShortcut(QKeySequence(Qt::Key_Space));
+
+  m_startBox = new QSpinBox();
+  m_startBox->setRange(-100000, 100000);
+  m_startBox->setValue(1);
+
+  m_slider = new QSlider(Qt::Horizontal);
+
+  m_endBox = new QSpinBox();
+  m_endBox->setRange(-100000, 100000);
+  m_endBox->setValue(120);
+
+  m_frameBox = new QSpinBox();
+
+  m_fpsBox = new QDoubleSpinBox();
+  m_fpsBox->setRange(1.0, 240.0);
+  m_fpsBox->setDecimals(2);
+  m_fpsBox->setValue(24.0);
+  m_fpsBox->setSuffix(" fps");
+
+  h->addWidget(m_play);
+  h->addWidget(m_startBox);
+  h->addWidget(m_slider, 1);
+  h->addWidget(m_endBox);
+  h->addWidget(new QLabel("Frame"));
+  h->addWidget(m_frameBox);
+  h->addWidget(m_fpsBox);
+
+  updateRange();
+
+  m_timer = new QTimer(this);
+  m_timer->setTimerType(Qt::PreciseTimer);
+  connect(m_timer, &QTimer::timeout, this, &TimelineWidget::tick);
+
+  connect(m_play, &QPushButton::toggled, this, &TimelineWidget::setPlaying);
+  connect(m_slider, &QSlider::valueChanged, this, &TimelineWidget::setFrame);
+  connect(m_frameBox, &QSpinBox::valueChanged, this, &TimelineWidget::setFrame);
+  connect(m_startBox, &QSpinBox::valueChanged, this, [this](int) { updateRange(); });
+  connect(m_endBox, &QSpinBox::valueChanged, this, [this](int) { updateRange(); });
+  connect(m_fpsBox, qOverload<double>(&QDoubleSpinBox::valueChanged), this, [this](double)
+  {
+    // keep playing from here at the new rate
+    m_clockFrame = m_frame;
+    m_clock.restart();
+    if (m_playing) m_timer->start(std::max(1, int(500.0 / fps())));
+  });
+}
+
+int TimelineWidget::startFrame() const
+{
+  return std::min(m_startBox->value(), m_endBox->value());
+}
+
+int TimelineWidget::endFrame() const
+{
+  return std::max(m_startBox->value(), m_endBox->value());
+}
+
+double TimelineWidget::fps() const
+{
+  return m_fpsBox->value();
+}
+
+void TimelineWidget::updateRange()
+{
+  const QSignalBlocker b1(m_slider);
+  const QSignalBlocker b2(m_frameBox);
+  m_slider->setRange(startFrame(), endFrame());
+  m_frameBox->setRange(startFrame(), endFrame());
+  showFrame(m_frame);
+}
+
+void TimelineWidget::setFrame(int frame)
+{
+  frame = std::clamp(frame, startFrame(), endFrame());
+  if (m_playing)
+  {
+    // scrubbed while playing: carry on from here
+    m_clockFrame = frame;
+    m_clock.restart();
+  }
+  showFrame(frame);
+}
+
+void TimelineWidget::showFrame(int frame)
+{
+  frame = std::clamp(frame, startFrame(), endFrame());
+  {
+    const QSignalBlocker b1(m_slider);
+    const QSignalBlocker b2(m_frameBox);
+    m_slider->setValue(frame);
+    m_frameBox->setValue(frame);
+  }
+  if (frame == m_frame) return;
+
+  m_frame = frame;
+  emit frameChanged(frame);
+}
+
+void TimelineWidget::setPlaying(bool on)
+{
+  if (on == m_playing) return;
+  m_playing = on;
+
+  {
+    const QSignalBlocker b(m_play);
+    m_play->setChecked(on);
+  }
+  m_play->setText(on ? "Stop" : "Play");
+
+  if (on)
+  {
+    m_clockFrame = m_frame;
+    m_clock.start();
+    // twice per frame, so a late timer never costs a whole frame
+    m_timer->start(std::max(1, int(500.0 / fps())));
+  }
+  else m_timer->stop();
+
+  emit playingChanged(on);
+}
+
+void TimelineWidget::tick()
+{
+  // Where the wall clock says we are, looping over [start, end].
+  const int length = endFrame() - startFrame() + 1;
+  const qint64 advanced = qint64(std::floor(double(m_clock.elapsed()) * fps() / 1000.0));
+  const qint64 offset = ((qint64(m_clockFrame - startFrame()) + advanced) % length + length) % length;
+  showFrame(startFrame() + int(offset));
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QWidget>
+
+class QDoubleSpinBox;
+class QPushButton;
+class QSlider;
+class QSpinBox;
+class QTimer;
+
+// Frame slider with play/stop. Playback follows the wall clock: when frames
+// take longer than 1/fps to show, it skips ahead instead of slowing down.
+class TimelineWidget final : public QWidget
+{
+    Q_OBJECT
+  public:
+    explicit TimelineWidget(QWidget* parent = nullptr);
+
+    int frame() const { return m_frame; }
+    int startFrame() const;
+    int endFrame() const;
+    double fps() const;
+    bool playing() const { return m_playing; }
+
+    void setFrame(int frame);
+    void setPlaying(bool on);
+
+    signals:
+      void frameChanged(int frame);
+      void playingChanged(bool playing);
+
+private:
+    int m_frame = 1;
+    bool m_playing = false;
+
+    QPushButton* m_play = nullptr;
+    QSlider* m_slider = nullptr;
+    QSpinBox* m_frameBox = nullptr;
+    QSpinBox* m_startBox = nullptr;
+    QSpinBox* m_endBox = nullptr;
+    QDoubleSpinBox* m_fpsBox = nullptr;
+
+    QTimer* m_timer = nullptr;
+    QElapsedTimer m_clock; // since playback (re)started at m_clockFrame
+    int m_clockFrame = 1;
+
+    void tick();
+    void showFrame(int frame); // move the controls there, without touching the clock
+    void updateRange();
+};
@@ -1,12 +1,20 @@
 #include "ViewportWidget.h"
 #include <QWheelEvent>
+#include <QPainter>
+#include <QFontDatabase>
+#include <QStringList>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "core/eval/DiskCache.h"
+#include "core/util/Profiler.h"
 
 ViewportWidget::ViewportWidget(QWidget* parent)
   : QOpenGLWidget(parent)
 {
   setFocusPolicy(Qt::StrongFocus);
-  m_showViewportGrid = true;
 
   m_yaw   = 50.0f;
   m_pitch = 20.0f;   // +Y side (avoid 90° singularity)
@@ -17,186 +25,433 @@ void ViewportWidget::setGraphAndCooker(Graph* g, Cooker* c)
 {
   m_graph = g;
   m_cooker = c;
-  update();
+  requestCook();
 }
 
 void ViewportWidget::setDisplayNode(NodeId id)
 {
   m_displayNode = id;
+  requestCook();
+}
+
+void ViewportWidget::setFrame(int frame, double fps)
+{
+  if (frame == m_frame && fps == m_fps) return;
+  m_frame = frame;
+  m_fps = fps;
+  requestCook();
+}
+
+void ViewportWidget::requestCook(bool preview)
+{
+  const uint64_t gen = ++m_cookGen;
+
+  if (!m_graph || !m_cooker || m_displayNode == 0)
+  {
+    m_geo.reset();
+    update();
+    return;
+  }
+
+  // The callback runs on the cooker thread; hop back to the GUI thread.
+  // (The cooker is torn down before this widget, so `this` outlives it.)
+  auto onDone = [this, gen](std::shared_ptr<const Geometry> geo)
+  {
+    if (!geo) return; // cancelled / superseded
+    QMetaObject::invokeMethod(this, [this, gen, geo = std::move(geo)]() mutable
+    {
+      onCookFinished(gen, std::move(geo));
+    }, Qt::QueuedConnection);
+  };
+
+  auto onProgress = [this, gen](float f)
+  {
+    QMetaObject::invokeMethod(this, [this, gen, f]() { onCookProgress(gen, f); },
+                              Qt::QueuedConnection);
+  };
+
+  CookOptions options;
+  options.preview = preview;
+  options.frame = m_frame;
+  options.fps = m_fps;
+  m_cooker->evaluateAsync(m_displayNode, std::move(onDone), std::move(onProgress), options);
+}
+
+void ViewportWidget::onCookProgress(uint64_t gen, float fraction)
+{
+  if (gen != m_cookGen) return;
+  emit cookProgress(fraction);
+}
+
+void ViewportWidget::onCookFinished(uint64_t gen, std::shared_ptr<const Geometry> geo)
+{
+  if (gen != m_cookGen) return;
+  m_geo = std::move(geo);
+  emit cookProgress(1.0f);
   update();
 }
 
+namespace
+{
+  // Positions arrive as three scalar attributes so the SoA blocks upload as-is.
+  const char* kMeshVs = R"(#version 330 core
+layout(location = 0) in float px;
+layout(location = 1) in float py;
+layout(location = 2) in float pz;
+uniform mat4 u_mvp;
+void main() { gl_Position = u_mvp * vec4(px, py, pz, 1.0); }
+)";
+
+  const char* kMeshFs = R"(#version 330 core
+uniform vec3 u_color;
+out vec4 fragColor;
+void main() { fragColor = vec4(u_color, 1.0); }
+)";
+
+  const char* kLineVs = R"(#version 330 core
+layout(location = 0) in vec3 pos;
+layout(location = 1) in vec3 color;
+uniform mat4 u_mvp;
+out vec3 v_color;
+void main() { v_color = color; gl_Position = u_mvp * vec4(pos, 1.0); }
+)";
+
+  const char* kLineFs = R"(#version 330 core
+in vec3 v_color;
+out vec4 fragColor;
+void main() { fragColor = vec4(v_color, 1.0); }
+)";
+
+  struct LineVertex
+  {
+    float x, y, z;
+    float r, g, b;
+  };
+}
+
+ViewportWidget::~ViewportWidget()
+{
+  if (m_showHud) Profiler::instance().removeUser();
+  makeCurrent();
+  cleanupGL();
+  doneCurrent();
+}
+
 void ViewportWidget::initializeGL()
 {
   initializeOpenGLFunctions();
   glEnable(GL_DEPTH_TEST);
+
+  m_meshProgram = std::make_unique<QOpenGLShaderProgram>();
+  m_meshProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, kMeshVs);
+  m_meshProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, kMeshFs);
+  m_meshProgram->link();
+  m_lineProgram = std::make_unique<QOpenGLShaderProgram>();
+  m_lineProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, kLineVs);
+  m_lineProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, kLineFs);
+  m_lineProgram->link();
+
+  glGenVertexArrays(1, &m_meshVao);
+  glGenBuffers(1, &m_meshVbo);
+  glGenBuffers(1, &m_meshIbo);
+  glGenVertexArrays(1, &m_lineVao);
+  glGenBuffers(1, &m_lineVbo);
+
+  buildLineBuffers(/*halfSize*/ 10.0f, /*majorStep*/ 1.0f, /*minorStep*/ 0.2f);
+
+  // a fresh context has nothing uploaded
+  m_meshKey = {};
+  m_uploadedGeo.reset();
+  m_meshIndexCount = 0;
+
+  // the widget can get a new context (e.g. when reparented)
+  connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, [this]()
+  {
+    makeCurrent();
+    cleanupGL();
+    doneCurrent();
+  }, Qt::UniqueConnection);
 }
 
-void ViewportWidget::resizeGL(int w, int h)
+void ViewportWidget::cleanupGL()
 {
-  glViewport(0, 0, w, h);
+  if (!m_meshVao) return;
+
+  glDeleteVertexArrays(1, &m_meshVao);
+  glDeleteBuffers(1, &m_meshVbo);
+  glDeleteBuffers(1, &m_meshIbo);
+  glDeleteVertexArrays(1, &m_lineVao);
+  glDeleteBuffers(1, &m_lineVbo);
+  m_meshVao = m_meshVbo = m_meshIbo = m_lineVao = m_lineVbo = 0;
+
+  m_meshProgram.reset();
+  m_lineProgram.reset();
+
+  m_meshKey = {};
+  m_uploadedGeo.reset();
+  m_meshIndexCount = 0;
 }
 
-static void matIdentity(float m[16])
+void ViewportWidget::resizeGL(int w, int h)
 {
-  for (int i=0;i<16;i++) m[i] = 0.0f;
-  m[0]=m[5]=m[10]=m[15]=1.0f;
+  glViewport(0, 0, w, h);
 }
 
-// Very small fixed-function-like camera using legacy matrices.
-// (Fine for MVP. Later replace with shader pipeline.)
-void ViewportWidget::applySimpleCamera(int w, int h)
+QMatrix4x4 ViewportWidget::viewProjection(int w, int h) const
 {
   const float aspect = (h == 0) ? 1.0f : float(w) / float(h);
 
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-
-  // simple perspective
-  const float fov = 45.0f;
-  const float n = 0.01f;
-  const float f = 100.0f;
-
-  const float top = std::tan(fov * 0.5f * 3.1415926f / 180.0f) * n;
-  const float right = top * aspect;
-  glFrustum(-right, right, -top, top, n, f);
-
-  glMatrixMode(GL_MODELVIEW);
-  glLoadIdentity();
+  QMatrix4x4 proj;
+  proj.perspective(45.0f, aspect, 0.01f, 100.0f);
 
   // orbit camera around origin
   const float yawR = m_yaw * 3.1415926f / 180.0f;
   const float pitchR = m_pitch * 3.1415926f / 180.0f;
 
-  const float cx = m_dist * std::cos(pitchR) * std::sin(yawR);
-  const float cy = m_dist * std::sin(pitchR);
-  const float cz = m_dist * std::cos(pitchR) * std::cos(yawR);
-
-  // lookAt (very basic)
-  const float eye[3] = {cx, cy, cz};
-  const float at[3]  = {0, 0, 0};
-  const float up[3]  = {0, 1, 0};
-
-  // compute forward, right, up
-  float fx = at[0]-eye[0], fy = at[1]-eye[1], fz = at[2]-eye[2];
-  const float fl = std::sqrt(fx*fx+fy*fy+fz*fz);
-  fx/=fl; fy/=fl; fz/=fl;
-
-  float rx = fy*up[2]-fz*up[1];
-  float ry = fz*up[0]-fx*up[2];
-  float rz = fx*up[1]-fy*up[0];
-  const float rl = std::sqrt(rx*rx+ry*ry+rz*rz);
-  rx/=rl; ry/=rl; rz/=rl;
-
-  float ux = ry*fz-rz*fy;
-  float uy = rz*fx-rx*fz;
-  float uz = rx*fy-ry*fx;
-
-  float M[16]; matIdentity(M);
-  M[0]=rx; M[4]=ry; M[8]=rz;
-  M[1]=ux; M[5]=uy; M[9]=uz;
-  M[2]=-fx;M[6]=-fy;M[10]=-fz;
-
-  glMultMatrixf(M);
-  glTranslatef(-eye[0], -eye[1], -eye[2]);
+  const QVector3D eye(m_dist * std::cos(pitchR) * std::sin(yawR),
+                      m_dist * std::sin(pitchR),
+                      m_dist * std::cos(pitchR) * std::cos(yawR));
+
+  QMatrix4x4 view;
+  view.lookAt(eye, QVector3D(0, 0, 0), QVector3D(0, 1, 0));
+  return proj * view;
 }
 
 #include <QKeyEvent>
 
-void ViewportWidget::drawViewportGrid(float halfSize, float majorStep, float minorStep)
+// Axes and the XZ grid never change, so they're built once per context.
+void ViewportWidget::buildLineBuffers(float halfSize, float majorStep, float minorStep)
 {
-  // Grid on the XZ plane (Y=0)
-  // minor lines
-  glColor3f(0.18f, 0.18f, 0.20f);
-  glBegin(GL_LINES);
-  for (float x = -halfSize; x <= halfSize + 0.0001f; x += minorStep)
+  std::vector<LineVertex> v;
+
+  v.push_back({0,0,0, 1,0,0}); v.push_back({1,0,0, 1,0,0});
+  v.push_back({0,0,0, 0,1,0}); v.push_back({0,1,0, 0,1,0});
+  v.push_back({0,0,0, 0,0,1}); v.push_back({0,0,1, 0,0,1});
+  m_axisVertexCount = GLsizei(v.size());
+
+  auto addLines = [&](float step, float c0, float c1, float c2)
   {
-    glVertex3f(x, 0.0f, -halfSize);
-    glVertex3f(x, 0.0f,  halfSize);
+    for (float x = -halfSize; x <= halfSize + 0.0001f; x += step)
+    {
+      v.push_back({x, 0.0f, -halfSize, c0, c1, c2});
+      v.push_back({x, 0.0f,  halfSize, c0, c1, c2});
+    }
+    for (float z = -halfSize; z <= halfSize + 0.0001f; z += step)
+    {
+      v.push_back({-halfSize, 0.0f, z, c0, c1, c2});
+      v.push_back({ halfSize, 0.0f, z, c0, c1, c2});
+    }
+  };
+  addLines(minorStep, 0.18f, 0.18f, 0.20f);
+  addLines(majorStep, 0.26f, 0.26f, 0.30f);
+  m_gridVertexCount = GLsizei(v.size()) - m_axisVertexCount;
+
+  glBindVertexArray(m_lineVao);
+  glBindBuffer(GL_ARRAY_BUFFER, m_lineVbo);
+  glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(v.size() * sizeof(LineVertex)), v.data(), GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex), nullptr);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex),
+                        reinterpret_cast<const void*>(offsetof(LineVertex, r)));
+  glEnableVertexAttribArray(0);
+  glEnableVertexAttribArray(1);
+  glBindVertexArray(0);
+}
+
+// Uploads only what changed since the last draw, compared by buffer identity:
+// - a cook sharing all its buffers with the last one (Null, cache hit) is free
+// - same topology with moved points (Transform scrubbing) rewrites just the
+//   changed P components in place, leaving the index buffer alone
+// - the VBO is reallocated only when the point count changes
+size_t ViewportWidget::uploadMesh(const std::shared_ptr<const Geometry>& geo)
+{
+  MeshKey key;
+  if (geo && !geo->empty())
+  {
+    const Attribute& P = geo->P();
+    key = {P.floatBuffer(0).identity(), P.floatBuffer(1).identity(), P.floatBuffer(2).identity(),
+           geo->Tris.identity(), geo->numPoints(), geo->numPrims()};
   }
-  for (float z = -halfSize; z <= halfSize + 0.0001f; z += minorStep)
+
+  m_uploadedGeo = geo;
+  if (key == m_meshKey) return 0;
+
+  if (key.points == 0 || key.prims == 0)
   {
-    glVertex3f(-halfSize, 0.0f, z);
-    glVertex3f( halfSize, 0.0f, z);
+    m_meshKey = {};
+    m_meshIndexCount = 0;
+    return 0;
   }
-  glEnd();
 
-  // major lines
-  glColor3f(0.26f, 0.26f, 0.30f);
-  glBegin(GL_LINES);
-  for (float x = -halfSize; x <= halfSize + 0.0001f; x += majorStep)
+  const Attribute& P = geo->P();
+  const GLsizeiptr block = GLsizeiptr(key.points * sizeof(float));
+  const bool resized = key.points != m_meshKey.points;
+  const void* const ids[3] = {key.px, key.py, key.pz};
+  const void* const oldIds[3] = {m_meshKey.px, m_meshKey.py, m_meshKey.pz};
+
+  size_t uploaded = 0;
+  glBindVertexArray(m_meshVao);
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_meshVbo);
+  if (resized)
+    glBufferData(GL_ARRAY_BUFFER, 3 * block, nullptr, GL_DYNAMIC_DRAW);
+  for (int k = 0; k < 3; ++k)
   {
-    glVertex3f(x, 0.0f, -halfSize);
-    glVertex3f(x, 0.0f,  halfSize);
+    if (!resized && ids[k] == oldIds[k]) continue;
+    glBufferSubData(GL_ARRAY_BUFFER, k * block, block, P.floats(k));
+    uploaded += size_t(block);
+    if (resized)
+    {
+      glVertexAttribPointer(GLuint(k), 1, GL_FLOAT, GL_FALSE, sizeof(float),
+                            reinterpret_cast<const void*>(k * block));
+      glEnableVertexAttribArray(GLuint(k));
+    }
   }
-  for (float z = -halfSize; z <= halfSize + 0.0001f; z += majorStep)
+
+  if (key.tris != m_meshKey.tris || key.prims != m_meshKey.prims)
   {
-    glVertex3f(-halfSize, 0.0f, z);
-    glVertex3f( halfSize, 0.0f, z);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_meshIbo); // recorded in the VAO
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, GLsizeiptr(key.prims * sizeof(Tri)), geo->Tris.data(), GL_STATIC_DRAW);
+    uploaded += key.prims * sizeof(Tri);
   }
-  glEnd();
+
+  glBindVertexArray(0);
+  m_meshKey = key;
+  m_meshIndexCount = GLsizei(key.prims * 3);
+  return uploaded;
 }
 
 void ViewportWidget::paintGL()
 {
+  glEnable(GL_DEPTH_TEST); // the HUD's QPainter may have turned it off
   glClearColor(0.08f, 0.08f, 0.09f, 1.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-  applySimpleCamera(width(), height());
+  {
+    ProfileScope upload(ProfileKind::Upload, "upload");
+    upload.event().bytes = uploadMesh(m_geo);
+  }
 
-  // Draw simple ground axes
-  glBegin(GL_LINES);
-    glColor3f(1,0,0); glVertex3f(0,0,0); glVertex3f(1,0,0);
-    glColor3f(0,1,0); glVertex3f(0,0,0); glVertex3f(0,1,0);
-    glColor3f(0,0,1); glVertex3f(0,0,0); glVertex3f(0,0,1);
-  glEnd();
+  {
+    ProfileScope draw(ProfileKind::Draw, "draw"); // CPU-side submission time
 
-  if (m_showViewportGrid)
-    drawViewportGrid(/*halfSize*/ 10.0f, /*majorStep*/ 1.0f, /*minorStep*/ 0.2f);
+    const QMatrix4x4 mvp = viewProjection(width(), height());
 
-  if (!m_graph || !m_cooker || m_displayNode == 0) return;
+    m_lineProgram->bind();
+    m_lineProgram->setUniformValue("u_mvp", mvp);
+    glBindVertexArray(m_lineVao);
+    glDrawArrays(GL_LINES, 0, m_axisVertexCount);
+    if (m_showViewportGrid)
+      glDrawArrays(GL_LINES, m_axisVertexCount, m_gridVertexCount);
+    m_lineProgram->release();
 
-  auto geo = m_cooker->evaluate(m_displayNode);
-  if (!geo || geo->empty()) return;
+    if (m_meshIndexCount > 0)
+    {
+      m_meshProgram->bind();
+      m_meshProgram->setUniformValue("u_mvp", mvp);
+      glBindVertexArray(m_meshVao);
+
+      // Filled draw (surface)
+      glDisable(GL_CULL_FACE);
+      glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+      m_meshProgram->setUniformValue("u_color", QVector3D(0.85f, 0.85f, 0.9f));
+      glDrawElements(GL_TRIANGLES, m_meshIndexCount, GL_UNSIGNED_INT, nullptr);
+
+      // Optional wireframe overlay (toggle)
+      if (m_showGeoWireframe)
+      {
+        glEnable(GL_POLYGON_OFFSET_LINE);
+        glPolygonOffset(-1.0f, -1.0f); // pull lines toward camera to reduce z-fighting
+
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        m_meshProgram->setUniformValue("u_color", QVector3D(0.05f, 0.05f, 0.06f));
+        glDrawElements(GL_TRIANGLES, m_meshIndexCount, GL_UNSIGNED_INT, nullptr);
+
+        glDisable(GL_POLYGON_OFFSET_LINE);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+      }
+      m_meshProgram->release();
+    }
+
+    glBindVertexArray(0);
+  }
 
-  // Filled draw (surface)
-  glDisable(GL_CULL_FACE);
-  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-  glColor3f(0.85f, 0.85f, 0.9f);
-  glBegin(GL_TRIANGLES);
-  for (const auto& t : geo->Tris)
+  if (m_showHud)
+    drawHud();
+}
+
+// Profiler overlay: last frame, last cook and its slowest nodes, cache state.
+void ViewportWidget::drawHud()
+{
+  const auto events = Profiler::instance().snapshot();
+
+  const ProfileEvent* upload = nullptr;
+  const ProfileEvent* draw = nullptr;
+  const ProfileEvent* eval = nullptr;
+  for (auto it = events.rbegin(); it != events.rend(); ++it)
   {
-    const auto& a = geo->P[t.a];
-    const auto& b = geo->P[t.b];
-    const auto& c = geo->P[t.c];
-    glVertex3f(a.x, a.y, a.z);
-    glVertex3f(b.x, b.y, b.z);
-    glVertex3f(c.x, c.y, c.z);
+    if (!upload && it->kind == ProfileKind::Upload) upload = &*it;
+    if (!draw && it->kind == ProfileKind::Draw) draw = &*it;
+    if (!eval && it->kind == ProfileKind::Evaluate) eval = &*it;
   }
-  glEnd();
 
-  // Optional wireframe overlay (toggle)
-  if (m_showGeoWireframe)
+  auto ms = [](const ProfileEvent* e) { return e ? double(e->durationNs) / 1e6 : 0.0; };
+  auto mb = [](uint64_t bytes) { return double(bytes) / (1024.0 * 1024.0); };
+
+  QStringList lines;
+  lines << QString("frame  upload %1 ms (%2 MB)  draw %3 ms")
+             .arg(ms(upload), 0, 'f', 2).arg(mb(upload ? upload->bytes : 0), 0, 'f', 1).arg(ms(draw), 0, 'f', 2);
+
+  if (eval)
   {
-    glEnable(GL_POLYGON_OFFSET_LINE);
-    glPolygonOffset(-1.0f, -1.0f); // pull lines toward camera to reduce z-fighting
+    std::vector<const ProfileEvent*> nodes;
+    int cooked = 0, cached = 0;
+    for (const auto& e : events)
+    {
+      if (e.evalId != eval->evalId) continue;
+      if (e.kind == ProfileKind::Cook) { nodes.push_back(&e); ++cooked; }
+      else if (e.kind == ProfileKind::CacheHit) ++cached;
+    }
+    std::sort(nodes.begin(), nodes.end(),
+              [](const ProfileEvent* a, const ProfileEvent* b) { return a->durationNs > b->durationNs; });
+
+    lines << QString("cook   %1 ms  %2 cooked, %3 cached")
+               .arg(ms(eval), 0, 'f', 2).arg(cooked).arg(cached);
+    for (size_t i = 0; i < nodes.size() && i < 5; ++i)
+      lines << QString("  %1 %2 ms  %3 MB")
+                 .arg(QString::fromUtf8(nodes[i]->name), -16).arg(ms(nodes[i]), 8, 'f', 2)
+                 .arg(mb(nodes[i]->bytes), 0, 'f', 1);
+  }
 
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    glColor3f(0.05f, 0.05f, 0.06f);
-    glBegin(GL_TRIANGLES);
-    for (const auto& t : geo->Tris)
+  if (m_cooker)
+  {
+    const CacheStats cs = m_cooker->cacheStats();
+    lines << QString("cache  %1 hits  %2 misses  %3 evictions")
+               .arg(cs.hits).arg(cs.misses).arg(cs.evictions);
+    lines << QString("       %1 entries  %2 / %3 MB").arg(cs.entries).arg(mb(cs.bytes), 0, 'f', 1)
+               .arg(cs.budgetBytes ? QString::number(mb(cs.budgetBytes), 'f', 0) : QString("unlimited"));
+    if (const auto& disk = m_cooker->diskCache())
     {
-      const auto& a = geo->P[t.a];
-      const auto& b = geo->P[t.b];
-      const auto& c = geo->P[t.c];
-      glVertex3f(a.x, a.y, a.z);
-      glVertex3f(b.x, b.y, b.z);
-      glVertex3f(c.x, c.y, c.z);
+      const DiskCacheStats ds = disk->stats();
+      lines << QString("disk   %1 hits  %2 writes  %3 MB").arg(cs.diskHits).arg(ds.writes)
+                 .arg(mb(ds.bytes), 0, 'f', 1);
     }
-    glEnd();
+  }
+
+  QPainter p(this);
+  p.setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  const QFontMetrics fm = p.fontMetrics();
+
+  int w = 0;
+  for (const auto& l : lines) w = std::max(w, fm.horizontalAdvance(l));
+  const QRect box(8, 8, w + 16, fm.height() * int(lines.size()) + 12);
 
-    glDisable(GL_POLYGON_OFFSET_LINE);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+  p.fillRect(box, QColor(0, 0, 0, 160));
+  p.setPen(QColor(220, 220, 225));
+  int y = box.top() + 6 + fm.ascent();
+  for (const auto& l : lines)
+  {
+    p.drawText(box.left() + 8, y, l);
+    y += fm.height();
   }
 }
 
@@ -249,6 +504,15 @@ void ViewportWidget::keyPressEvent(QKeyEvent* e)
     update();
     return;
   }
+  if (e->key() == Qt::Key_P)
+  {
+    m_showHud = !m_showHud;
+    // the HUD is what reads the events; record only while it's up
+    if (m_showHud) Profiler::instance().addUser();
+    else Profiler::instance().removeUser();
+    update();
+    return;
+  }
   if (e->key() == Qt::Key_W)
   {
     m_showGeoWireframe = !m_showGeoWireframe;
@@ -1,19 +1,33 @@
 #pragma once
 #include <QOpenGLWidget>
-#include <QOpenGLFunctions>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLShaderProgram>
+#include <QMatrix4x4>
 #include <QPoint>
+#include <memory>
 
 #include "core/graph/Graph.h"
 #include "core/eval/Cooker.h"
 
-class ViewportWidget final : public QOpenGLWidget, protected QOpenGLFunctions
+class ViewportWidget final : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core
 {
     Q_OBJECT
   public:
     explicit ViewportWidget(QWidget* parent = nullptr);
+    ~ViewportWidget() override;
 
     void setGraphAndCooker(Graph* g, Cooker* c);
     void setDisplayNode(NodeId id);
+    // Timeline frame to cook the display node at.
+    void setFrame(int frame, double fps);
+
+    // Start a background cook of the display node. The last completed result
+    // keeps being drawn until the new one lands. preview: cheap cook while a
+    // parameter is being scrubbed (CookContext::preview).
+    void requestCook(bool preview = false);
+
+signals:
+    void cookProgress(float fraction); // of the current background cook
 
 protected:
     void initializeGL() override;
@@ -28,6 +42,43 @@ private:
     Graph* m_graph = nullptr;
     Cooker* m_cooker = nullptr;
     NodeId m_displayNode = 0;
+    int m_frame = 1;
+    double m_fps = 24.0;
+
+    std::shared_ptr<const Geometry> m_geo; // last completed cook
+    uint64_t m_cookGen = 0;                // drops late results of superseded requests
+
+    void onCookFinished(uint64_t gen, std::shared_ptr<const Geometry> geo);
+    void onCookProgress(uint64_t gen, float fraction);
+
+    // GPU copy of the displayed geometry. Positions go up as three SoA blocks
+    // (all X, then all Y, then all Z) straight from the attribute buffers.
+    struct MeshKey
+    {
+        const void* px = nullptr;
+        const void* py = nullptr;
+        const void* pz = nullptr;
+        const void* tris = nullptr;
+        size_t points = 0;
+        size_t prims = 0;
+        bool operator==(const MeshKey&) const = default;
+    };
+
+    std::unique_ptr<QOpenGLShaderProgram> m_meshProgram;
+    std::unique_ptr<QOpenGLShaderProgram> m_lineProgram;
+    GLuint m_meshVao = 0, m_meshVbo = 0, m_meshIbo = 0;
+    GLuint m_lineVao = 0, m_lineVbo = 0;
+    GLsizei m_meshIndexCount = 0;
+    GLsizei m_axisVertexCount = 0;
+    GLsizei m_gridVertexCount = 0;
+    MeshKey m_meshKey;
+    // Keeps the uploaded buffers alive so their identities can't be reused
+    // by a later cook while m_meshKey still refers to them.
+    std::shared_ptr<const Geometry> m_uploadedGeo;
+
+    void cleanupGL();
+    size_t uploadMesh(const std::shared_ptr<const Geometry>& geo); // bytes sent to the GPU
+    void buildLineBuffers(float halfSize, float majorStep, float minorStep);
 
     // ultra-simple camera
     float m_yaw = 30.0f;
@@ -35,11 +86,12 @@ private:
     float m_dist = 3.0f;
     QPoint m_lastMouse;
 
-    bool m_showGeoWireframe;
-    bool m_showViewportGrid;
+    bool m_showGeoWireframe = false;
+    bool m_showViewportGrid = true;
+    bool m_showHud = false; // P: profiler overlay
 
-    void applySimpleCamera(int w, int h);
-    void drawViewportGrid(float halfSize, float majorStep, float minorStep);
+    QMatrix4x4 viewProjection(int w, int h) const;
+    void drawHud();
 
     void setShowViewportGrid(bool on);
     void setShowGeoWireframe(bool on);
@@ -0,0 +1,284 @@
+// Headless cooker: loads a graph file, cooks the requested nodes and writes
+// each result to disk. Links only src/core, so it runs without a display.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "core/eval/Cooker.h"
+#include "core/eval/DiskCache.h"
+#include "core/graph/Graph.h"
+#include "core/graph/GraphIO.h"
+#include "core/graph/NodeRegistry.h"
+#include "core/io/GeoFile.h"
+#include "core/io/ObjWriter.h"
+#include "core/ops/Builtins.h"
+#include "core/util/Profiler.h"
+
+namespace
+{
+    void usage()
+    {
+        std::fprintf(stderr,
+            "usage: hypersphere_batch [options] <graph> <node>...\n"
+            "  <graph>           text (.hsg) or binary (.hsgb) graph file\n"
+            "  <node>            node name or id to cook; writes <out>/<name>.<format>\n"
+            "                    (<name>.<frame>.<format> with --frames)\n"
+            "  -o, --out DIR     output directory (default: .)\n"
+            "  -f, --format F    obj or hgeo (default: obj)\n"
+            "  -j, --threads N   worker threads, 0 = all cores (default), 1 = serial\n"
+            "  -F, --frames A-B  cook every frame from A to B (or just A), in parallel\n"
+            "      --fps F       frames per second for time-dependent nodes (default: 24)\n"
+            "      --in-flight N frames cooked at once, 0 = one per thread (default)\n"
+            "  -t, --timing      print per-node cook times\n"
+            "  -c, --cache DIR   reuse (and add to) cooked results in DIR across runs\n"
+            "      --cache-mb N  size limit of the cache directory (default: 4096)\n"
+            "      --trace FILE  write a Chrome trace of the cooks\n");
+    }
+
+    double msSince(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    const Node* findNode(const Graph& g, const std::string& key)
+    {
+        for (NodeId id : g.allNodeIds())
+        {
+            const Node* n = g.get(id);
+            if (n->name() == key || std::to_string(id) == key) return n;
+        }
+        return nullptr;
+    }
+
+    // "<name>: <error>" lines for every node feeding root (root included)
+    // whose last cook failed; empty if none did.
+    std::string cookErrors(const Graph& g, NodeId root)
+    {
+        std::string out;
+        for (NodeId id : g.upstreamOf(root))
+        {
+            const Node* n = g.get(id);
+            const std::string error = n->cookError();
+            if (!error.empty()) out += n->name() + ": " + error + "\n";
+        }
+        return out;
+    }
+
+    // "A-B" or "A"; negative frames are fine ("-10--1").
+    bool parseFrames(const std::string& s, int& first, int& last)
+    {
+        char* end = nullptr;
+        first = int(std::strtol(s.c_str(), &end, 10));
+        if (end == s.c_str()) return false;
+        if (*end == '\0')
+        {
+            last = first;
+            return true;
+        }
+        if (*end != '-') return false;
+        const char* b = end + 1;
+        last = int(std::strtol(b, &end, 10));
+        return end != b && *end == '\0' && last >= first;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string outDir = ".";
+    std::string tracePath;
+    std::string format = "obj";
+    std::string cacheDir;
+    size_t cacheMb = 4096;
+    unsigned threads = 0;
+    unsigned inFlight = 0;
+    bool timing = false;
+    bool frameRange = false;
+    int firstFrame = 1, lastFrame = 1;
+    double fps = 24.0;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string a = argv[i];
+        auto value = [&]() -> const char*
+        {
+            if (i + 1 >= argc) { usage(); std::exit(2); }
+            return argv[++i];
+        };
+
+        if (a == "-o" || a == "--out") outDir = value();
+        else if (a == "-f" || a == "--format") format = value();
+        else if (a == "-j" || a == "--threads") threads = unsigned(std::strtoul(value(), nullptr, 10));
+        else if (a == "-t" || a == "--timing") timing = true;
+        else if (a == "-F" || a == "--frames")
+        {
+            if (!parseFrames(value(), firstFrame, lastFrame)) { usage(); return 2; }
+            frameRange = true;
+        }
+        else if (a == "--fps") fps = std::strtod(value(), nullptr);
+        else if (a == "--in-flight") inFlight = unsigned(std::strtoul(value(), nullptr, 10));
+        else if (a == "--trace") tracePath = value();
+        else if (a == "-c" || a == "--cache") cacheDir = value();
+        else if (a == "--cache-mb") cacheMb = size_t(std::strtoull(value(), nullptr, 10));
+        else if (a == "-h" || a == "--help") { usage(); return 0; }
+        else if (!a.empty() && a[0] == '-') { usage(); return 2; }
+        else positional.push_back(a);
+    }
+
+    if (positional.size() < 2 || (format != "obj" && format != "hgeo") || !(fps > 0.0))
+    {
+        usage();
+        return 2;
+    }
+
+    NodeRegistry registry;
+    registerBuiltinSops(registry);
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    Graph graph;
+    std::string error;
+    if (!loadGraphFile(positional[0], registry, graph, error))
+    {
+        std::fprintf(stderr, "%s: %s\n", positional[0].c_str(), error.c_str());
+        return 1;
+    }
+    if (timing) std::printf("load     %9.2f ms\n", msSince(t0));
+    if (timing || !tracePath.empty()) Profiler::instance().addUser(); // both read the events
+
+    Cooker cooker(&graph, threads == 1 ? CookMode::Serial : CookMode::Parallel, threads);
+    cooker.setCacheBudget(0); // one shot: keep every intermediate, nothing is re-cooked
+
+    std::shared_ptr<DiskCache> disk;
+    if (!cacheDir.empty())
+    {
+        DiskCacheOptions opts;
+        opts.maxBytes = cacheMb << 20;
+        // Every intermediate is kept anyway, so never drop a write; except
+        // per-frame results, which would pile up faster than they're written.
+        if (!frameRange) opts.maxPendingWrites = size_t(-1);
+        disk = std::make_shared<DiskCache>(cacheDir, opts);
+        if (!disk->valid())
+        {
+            std::fprintf(stderr, "cannot use cache directory %s\n", cacheDir.c_str());
+            return 1;
+        }
+        cooker.setDiskCache(disk);
+    }
+
+    auto write = [&format](const Geometry& geo, const std::string& path)
+    {
+        std::string error;
+        return format == "hgeo" ? writeGeo(geo, path, error) : writeObj(geo, path);
+    };
+
+    std::atomic<int> failures{0};
+    for (size_t i = 1; i < positional.size(); ++i)
+    {
+        const Node* node = findNode(graph, positional[i]);
+        if (!node)
+        {
+            std::fprintf(stderr, "no node named '%s'\n", positional[i].c_str());
+            ++failures;
+            continue;
+        }
+
+        if (frameRange)
+        {
+            // Files are written from the cook threads as frames land.
+            CookContext ctx;
+            ctx.fps = fps;
+            std::atomic<bool> cookFailed{false};
+            const auto tc = std::chrono::steady_clock::now();
+            cooker.cookFrames(node->id(), firstFrame, lastFrame, [&](int frame, std::shared_ptr<const Geometry> geo)
+            {
+                // don't leave a sequence of empty files behind a failed cook
+                if (cookFailed || !cookErrors(graph, node->id()).empty())
+                {
+                    cookFailed = true;
+                    return;
+                }
+                char suffix[32];
+                std::snprintf(suffix, sizeof(suffix), ".%04d.", frame);
+                const std::string path = outDir + "/" + node->name() + suffix + format;
+                if (!write(*geo, path))
+                {
+                    std::fprintf(stderr, "failed to write %s\n", path.c_str());
+                    ++failures;
+                }
+            }, ctx, inFlight);
+
+            if (cookFailed)
+            {
+                std::fprintf(stderr, "%s", cookErrors(graph, node->id()).c_str());
+                ++failures;
+                continue;
+            }
+
+            if (timing)
+            {
+                const double ms = msSince(tc);
+                const int frames = lastFrame - firstFrame + 1;
+                std::printf("%-16s %d frames %9.2f ms  %.1f frames/s\n", node->name().c_str(), frames, ms,
+                            ms > 0.0 ? frames * 1000.0 / ms : 0.0);
+            }
+            continue;
+        }
+
+        const auto tc = std::chrono::steady_clock::now();
+        CookContext ctx;
+        ctx.fps = fps;
+        const auto geo = cooker.evaluate(node->id(), ctx);
+        const double cookMs = msSince(tc);
+
+        if (const std::string errors = cookErrors(graph, node->id()); !errors.empty())
+        {
+            std::fprintf(stderr, "%s", errors.c_str());
+            ++failures;
+            continue;
+        }
+
+        const std::string path = outDir + "/" + node->name() + "." + format;
+        const auto tw = std::chrono::steady_clock::now();
+        if (!geo || !write(*geo, path))
+        {
+            std::fprintf(stderr, "failed to write %s\n", path.c_str());
+            ++failures;
+            continue;
+        }
+
+        if (timing)
+            std::printf("%-16s cook %9.2f ms  write %9.2f ms  %zu points %zu prims\n",
+                        node->name().c_str(), cookMs, msSince(tw), geo->numPoints(), geo->numPrims());
+    }
+
+    if (disk) disk->flush(); // the next run should find this one's results
+
+    if (timing)
+    {
+        // per-node breakdown straight from the profiler
+        for (const ProfileEvent& e : Profiler::instance().snapshot())
+            if (e.kind == ProfileKind::Cook)
+                std::printf("  %-24s %9.2f ms  %8.1f MB\n", e.name, double(e.durationNs) / 1e6,
+                            double(e.bytes) / (1024.0 * 1024.0));
+        if (disk)
+        {
+            const DiskCacheStats ds = disk->stats();
+            std::printf("disk     %llu hits  %llu writes  %.1f MB\n", (unsigned long long)ds.hits,
+                        (unsigned long long)ds.writes, double(ds.bytes) / (1024.0 * 1024.0));
+        }
+        std::printf("total    %9.2f ms\n", msSince(t0));
+    }
+
+    if (!tracePath.empty() && !Profiler::instance().writeChromeTrace(tracePath))
+    {
+        std::fprintf(stderr, "failed to write %s\n", tracePath.c_str());
+        ++failures;
+    }
+
+    return failures > 0 ? 1 : 0;
+}
@@ -1,60 +1,812 @@
 #include "core/eval/Cooker.h"
 
-std::shared_ptr<const Geometry> Cooker::evaluate(NodeId nodeId)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <unordered_set>
+
+#include "core/eval/DiskCache.h"
+#include "core/util/Hash.h"
+#include "core/util/Profiler.h"
+#include "core/util/ThreadPool.h"
+
+namespace
+{
+    constexpr size_t npos = size_t(-1);
+
+    // Key of a missing or cyclic input: an empty geometry.
+    const uint64_t kEmptyKey = Hasher().add("<empty>").value();
+
+    // Bytes in buffers a cook allocated itself, i.e. not shared with an input.
+    uint64_t producedBytes(const Geometry& out, const std::vector<std::shared_ptr<const Geometry>>& inputs)
+    {
+        std::unordered_set<const void*> inherited;
+        for (auto& in : inputs)
+            if (in) in->forEachBuffer([&](const void* id, size_t) { inherited.insert(id); });
+
+        uint64_t bytes = 0;
+        out.forEachBuffer([&](const void* id, size_t n) { if (!inherited.count(id)) bytes += n; });
+        return bytes;
+    }
+
+    void recordHit(uint64_t evalId, const Node* node, const Geometry* geo)
+    {
+        Profiler& prof = Profiler::instance();
+        if (!prof.enabled()) return;
+
+        ProfileEvent e;
+        e.kind = ProfileKind::CacheHit;
+        e.evalId = evalId;
+        e.node = node ? node->id() : 0;
+        e.startNs = prof.nowNs();
+        e.bytes = geo ? geo->byteSize() : 0;
+        if (node) e.setName(node->name());
+        prof.record(e);
+    }
+
+    // Folds per-node progress into one monotonic fraction for the caller,
+    // dropping updates smaller than a percent so SOP loops can report freely.
+    class ProgressTracker
+    {
+    public:
+        ProgressTracker(const CookContext& parent, size_t total)
+            : m_parent(parent), m_total(float(total)) {}
+
+        void nodeDone()
+        {
+            const size_t done = m_done.fetch_add(1, std::memory_order_relaxed) + 1;
+            report(float(done));
+        }
+
+        void nodeProgress(float fraction)
+        {
+            report(float(m_done.load(std::memory_order_relaxed)) + std::clamp(fraction, 0.0f, 1.0f));
+        }
+
+    private:
+        const CookContext& m_parent;
+        const float m_total;
+        std::atomic<size_t> m_done{0};
+        std::mutex m_mutex;
+        float m_last = 0.0f;
+
+        void report(float units)
+        {
+            const float f = std::min(1.0f, units / m_total);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (f < m_last + 0.01f && f < 1.0f) return;
+            m_last = f;
+            m_parent.reportProgress(f);
+        }
+    };
+}
+
+Cooker::Cooker(const Graph* g, CookMode mode, unsigned threadCount)
+    : m_graph(g)
+    , m_mode(mode)
+{
+    if (m_mode == CookMode::Parallel)
+        m_pool = std::make_unique<ThreadPool>(threadCount);
+}
+
+Cooker::~Cooker()
+{
+    stopPrefetch();
+    if (!m_worker.joinable()) return;
+
+    interrupt();
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_stopWorker = true;
+    }
+    m_jobCv.notify_all();
+    m_worker.join();
+}
+
+bool CookHandle::ready() const
+{
+    return m_future.valid()
+        && m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void Cooker::clearCache()
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_cache.clear();
+    m_store.clear();
+    m_lru.clear();
+    m_bufferRefs.clear();
+    m_stats.bytes = 0;
+}
+
+void Cooker::setCacheBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_budget = bytes;
+    evictToBudget();
+}
+
+void Cooker::setDiskCache(std::shared_ptr<DiskCache> disk)
+{
+    m_disk = std::move(disk);
+}
+
+CacheStats Cooker::cacheStats() const
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    CacheStats s = m_stats;
+    s.budgetBytes = m_budget;
+    s.entries = m_store.size();
+    return s;
+}
+
+std::shared_ptr<const Geometry> Cooker::storeFind(uint64_t key)
+{
+    auto it = m_store.find(key);
+    if (it == m_store.end()) return {};
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    ++m_stats.hits;
+    return it->second.geo;
+}
+
+void Cooker::storeInsert(uint64_t key, std::shared_ptr<const Geometry> geo)
+{
+    auto it = m_store.find(key);
+    if (it != m_store.end()) storeErase(it);
+
+    // Pass-through SOPs share buffers with their inputs: only charge the
+    // budget for buffers no other store entry holds yet.
+    geo->forEachBuffer([this](const void* id, size_t bytes)
+    {
+        if (id && m_bufferRefs[id]++ == 0) m_stats.bytes += bytes;
+    });
+
+    StoreEntry e;
+    e.geo = std::move(geo);
+    m_lru.push_front(key);
+    e.lru = m_lru.begin();
+    m_store.emplace(key, std::move(e));
+
+    evictToBudget();
+}
+
+void Cooker::storeErase(std::unordered_map<uint64_t, StoreEntry>::iterator it)
+{
+    it->second.geo->forEachBuffer([this](const void* id, size_t bytes)
+    {
+        if (!id) return;
+        auto ref = m_bufferRefs.find(id);
+        if (--ref->second == 0)
+        {
+            m_stats.bytes -= bytes;
+            m_bufferRefs.erase(ref);
+        }
+    });
+
+    m_lru.erase(it->second.lru);
+    m_store.erase(it);
+}
+
+void Cooker::evictToBudget()
+{
+    if (m_budget == 0) return;
+
+    // Walk from the cold end. An entry whose geometry has other owners is in
+    // use (on screen, or an input of a cook in flight); skip it.
+    auto it = m_lru.end();
+    while (m_stats.bytes > m_budget && it != m_lru.begin())
+    {
+        --it;
+        auto s = m_store.find(*it);
+        if (s->second.geo.use_count() > 1) continue;
+
+        auto next = std::next(it);
+        ++m_stats.evictions;
+        storeErase(s);
+        it = next;
+    }
+}
+
+void Cooker::markDirty(NodeId nodeId)
+{
+    if (!m_graph) return;
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+    std::unordered_set<NodeId> seen{nodeId};
+    std::vector<NodeId> stack{nodeId};
+    while (!stack.empty())
+    {
+        const NodeId id = stack.back();
+        stack.pop_back();
+        m_cache.erase(id);
+
+        for (NodeId out : m_graph->outputsOf(id))
+            if (seen.insert(out).second) stack.push_back(out);
+    }
+}
+
+CookHandle Cooker::evaluateAsync(NodeId nodeId, CookCallback onDone, ProgressCallback onProgress,
+                                 CookOptions options)
+{
+    AsyncJob job;
+    job.node = nodeId;
+    job.options = options;
+    job.token = std::make_shared<CancelToken>();
+    job.onDone = std::move(onDone);
+    job.onProgress = std::move(onProgress);
+
+    CookHandle handle;
+    handle.m_future = job.promise.get_future().share();
+    handle.m_token = job.token;
+
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+
+        // supersede everything older
+        for (auto& j : m_jobs) j.token->cancel();
+        if (m_runningToken) m_runningToken->cancel();
+
+        m_jobs.push_back(std::move(job));
+
+        if (!m_worker.joinable())
+            m_worker = std::thread([this]() { workerLoop(); });
+    }
+    m_jobCv.notify_all();
+
+    return handle;
+}
+
+void Cooker::interrupt()
+{
+    stopPrefetch();
+
+    std::unique_lock<std::mutex> lock(m_jobMutex);
+    for (auto& j : m_jobs) j.token->cancel();
+    if (m_runningToken) m_runningToken->cancel();
+
+    m_jobCv.wait(lock, [this]() { return m_jobs.empty() && !m_runningToken; });
+}
+
+void Cooker::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_jobMutex);
+    for (;;)
+    {
+        m_jobCv.wait(lock, [this]() { return m_stopWorker || !m_jobs.empty(); });
+        if (m_jobs.empty()) return; // stopping
+
+        AsyncJob job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_runningToken = job.token;
+        lock.unlock();
+
+        std::shared_ptr<const Geometry> result;
+        if (!job.token->cancelled())
+        {
+            CookContext ctx;
+            ctx.cancel = job.token.get();
+            ctx.progress = std::move(job.onProgress);
+            ctx.preview = job.options.preview;
+            ctx.frame = job.options.frame;
+            ctx.fps = job.options.fps;
+            waitForPrefetch(job.node, ctx);
+            result = evaluate(job.node, ctx);
+            if (job.token->cancelled()) result.reset();
+        }
+
+        job.promise.set_value(result);
+        if (job.onDone) job.onDone(std::move(result));
+
+        lock.lock();
+        m_runningToken.reset();
+        m_jobCv.notify_all(); // wake interrupt()
+    }
+}
+
+bool Cooker::cookFrames(NodeId nodeId, int first, int last, const FrameCallback& onFrame,
+                        const CookContext& ctx, unsigned maxInFlight)
+{
+    if (last < first) return true;
+    const int64_t total = int64_t(last) - first + 1;
+
+    auto frameContext = [&ctx](int frame)
+    {
+        CookContext fc;
+        fc.cancel = ctx.cancel;
+        fc.preview = ctx.preview;
+        fc.frame = frame;
+        fc.fps = ctx.fps;
+        return fc;
+    };
+
+    // Key the plan once to find the static frontier: nodes that don't change
+    // with time but feed ones that do. Static keys are the same at every frame.
+    std::vector<PlanNode> plan;
+    const size_t root = buildPlan(nodeId, plan);
+    if (root == npos) return true;
+
+    std::vector<Slot> slots(plan.size());
+    keyPlan(plan, slots, frameContext(first));
+
+    std::vector<char> frontier(plan.size(), 0);
+    if (!slots[root].varying) frontier[root] = 1;
+    for (size_t i = 0; i < plan.size(); ++i)
+        for (size_t in : plan[i].inputs)
+            if (slots[i].varying && in != npos && !slots[in].varying) frontier[in] = 1;
+
+    // Resolve the frontier up front (store, disk or cook; each lands in the
+    // store) and hold on to it for the whole range, whatever the store budget
+    // evicts meanwhile. The frames fanned out below then stop at it instead
+    // of racing each other to cook the static branches.
+    std::vector<std::shared_ptr<const Geometry>> pinned;
+    for (size_t i = 0; i < plan.size(); ++i)
+    {
+        if (!frontier[i] || !plan[i].node) continue;
+        auto g = evaluateImpl(plan[i].id, frameContext(first), false);
+        if (!g) return false;
+        pinned.push_back(std::move(g));
+    }
+
+    std::atomic<int64_t> done{0};
+
+    // Nothing changes with time: every frame is the same geometry.
+    if (!slots[root].varying)
+    {
+        const auto& geo = pinned.back(); // the root is last in plan order
+        for (int64_t f = first; f <= last; ++f)
+        {
+            if (ctx.cancelled()) return false;
+            onFrame(int(f), geo);
+            ctx.reportProgress(float(++done) / float(total));
+        }
+        return true;
+    }
+    slots.clear();
+
+    // Each runner takes the next frame until none are left, so at most
+    // `inFlight` frames are cooking (and held) at once.
+    std::atomic<int64_t> next{first};
+    std::atomic<bool> cancelled{false};
+    auto runner = [&]()
+    {
+        for (int64_t f; (f = next.fetch_add(1, std::memory_order_relaxed)) <= last;)
+        {
+            auto g = ctx.cancelled() ? nullptr : evaluateImpl(nodeId, frameContext(int(f)), false);
+            if (!g)
+            {
+                cancelled = true;
+                return;
+            }
+            onFrame(int(f), std::move(g));
+            ctx.reportProgress(float(done.fetch_add(1) + 1) / float(total));
+        }
+    };
+
+    const unsigned inFlight = m_pool ? (maxInFlight ? maxInFlight : std::max(1u, m_pool->size())) : 1;
+    if (inFlight > 1)
+    {
+        // The calling thread is one of the runners; pool threads are the rest
+        // (their frames still split their own cooks over the pool).
+        ThreadPool::TaskGroup group(*m_pool);
+        for (unsigned k = 1; k < inFlight && int64_t(k) < total; ++k) group.run(runner);
+        runner();
+        group.wait();
+    }
+    else runner();
+
+    return !cancelled;
+}
+
+void Cooker::prefetch(NodeId nodeId, std::vector<int> frames, double fps)
+{
+    // Frames already in the store need no thread.
+    if (m_graph)
+    {
+        CookContext ctx;
+        ctx.fps = fps;
+        frames.erase(std::remove_if(frames.begin(), frames.end(), [&](int f)
+        {
+            ctx.frame = f;
+            return inStore(nodeId, ctx);
+        }), frames.end());
+    }
+
+    // Called under m_prefetchMutex. Frames being cooked stay with their thread.
+    auto queue = [this, &frames]()
+    {
+        m_prefetchFrames.clear();
+        for (int f : frames)
+            if (!m_prefetchCooking.count(f)) m_prefetchFrames.push_back(f);
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+        if (!m_prefetchThreads.empty() && m_prefetchNode == nodeId && m_prefetchFps == fps)
+        {
+            // same playback, new window: frames already cooking carry on
+            queue();
+            m_prefetchCv.notify_all();
+            return;
+        }
+    }
+
+    stopPrefetch();
+
+    std::lock_guard<std::mutex> lock(m_prefetchMutex);
+    m_prefetchNode = nodeId;
+    m_prefetchFps = fps;
+    queue();
+    m_prefetchToken = std::make_shared<CancelToken>();
+    m_stopPrefetch = false;
+
+    // A few frames at once; each still spreads its own cooks over the pool.
+    const unsigned threads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    for (unsigned i = 0; i < threads; ++i)
+        m_prefetchThreads.emplace_back([this]() { prefetchLoop(); });
+}
+
+void Cooker::stopPrefetch()
+{
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+        if (m_prefetchThreads.empty()) return;
+        m_stopPrefetch = true;
+        m_prefetchFrames.clear();
+        m_prefetchToken->cancel();
+        threads.swap(m_prefetchThreads);
+    }
+    m_prefetchCv.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+void Cooker::prefetchLoop()
+{
+    std::unique_lock<std::mutex> lock(m_prefetchMutex);
+    const std::shared_ptr<CancelToken> token = m_prefetchToken;
+    for (;;)
+    {
+        m_prefetchCv.wait(lock, [this]() { return m_stopPrefetch || !m_prefetchFrames.empty(); });
+        if (m_stopPrefetch) return;
+
+        CookContext ctx;
+        ctx.cancel = token.get();
+        ctx.frame = m_prefetchFrames.front();
+        ctx.fps = m_prefetchFps;
+        const NodeId node = m_prefetchNode;
+        m_prefetchFrames.pop_front();
+        m_prefetchCooking.insert(ctx.frame);
+        lock.unlock();
+
+        evaluate(node, ctx); // the result stays behind in the store
+
+        lock.lock();
+        m_prefetchCooking.erase(ctx.frame);
+        m_prefetchCv.notify_all(); // wake waitForPrefetch
+    }
+}
+
+void Cooker::waitForPrefetch(NodeId nodeId, const CookContext& ctx)
+{
+    if (ctx.preview) return; // prefetch only cooks full resolution
+
+    std::unique_lock<std::mutex> lock(m_prefetchMutex);
+    auto cooking = [&]()
+    {
+        return !m_prefetchThreads.empty() && m_prefetchNode == nodeId && m_prefetchFps == ctx.fps
+            && m_prefetchCooking.count(ctx.frame);
+    };
+    // A superseded request doesn't wake the cv: poll its token.
+    while (cooking() && !ctx.cancelled())
+        m_prefetchCv.wait_for(lock, std::chrono::milliseconds(5));
+}
+
+bool Cooker::inStore(NodeId nodeId, const CookContext& ctx)
+{
+    std::vector<PlanNode> plan;
+    const size_t root = buildPlan(nodeId, plan);
+    if (root == npos) return false;
+
+    std::vector<Slot> slots(plan.size());
+    keyPlan(plan, slots, ctx);
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    return m_store.count(slots[root].key) != 0;
+}
+
+std::shared_ptr<const Geometry> Cooker::evaluate(NodeId nodeId, const CookContext& ctx)
 {
-    return evaluateInternal(nodeId);
+    return evaluateImpl(nodeId, ctx, true);
 }
 
-std::shared_ptr<const Geometry> Cooker::evaluateInternal(NodeId nodeId)
+std::shared_ptr<const Geometry> Cooker::evaluateImpl(NodeId nodeId, const CookContext& ctx, bool storeVarying)
 {
     if (!m_graph) return std::make_shared<Geometry>();
 
-    const Node* node = m_graph->get(nodeId);
-    if (!node) return std::make_shared<Geometry>();
+    const uint64_t evalId = Profiler::instance().newEvalId();
+    ProfileScope scope(ProfileKind::Evaluate, "evaluate");
+    scope.event().evalId = evalId;
+    scope.event().node = nodeId;
 
-    const uint64_t topoRev = m_graph->topologyRevision();
-    const uint64_t paramRev = node->paramRevision();
+    std::vector<PlanNode> plan;
+    const size_t root = buildPlan(nodeId, plan);
+    if (root == npos) return std::make_shared<Geometry>();
 
-    // Gather inputs
-    const auto inputIds = m_graph->inputsOf(nodeId);
-    std::vector<std::shared_ptr<const Geometry>> inputGeos;
-    inputGeos.reserve(inputIds.size());
+    std::vector<Slot> slots(plan.size());
+
+    // Keys only depend on input keys, so the whole plan can be keyed up front.
+    keyPlan(plan, slots, ctx);
+    auto keep = [&](size_t i) { return storeVarying || !slots[i].varying; };
+
+    // Walk down from the root (reverse plan order visits consumers before
+    // their inputs). A node already in the store or on disk cuts off its
+    // inputs: they are only needed if something has to be cooked from them.
+    std::vector<char> needed(plan.size(), 0);
+    needed[root] = 1;
+    size_t toResolve = 0;
+    for (size_t i = plan.size(); i-- > 0;)
+    {
+        if (!needed[i]) continue;
+        if (ctx.cancelled()) return {};
+
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            slots[i].geo = storeFind(slots[i].key);
+        }
+        if (!slots[i].geo && m_disk && plan[i].node)
+        {
+            slots[i].geo = m_disk->load(slots[i].key);
+            if (slots[i].geo)
+            {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                ++m_stats.diskHits;
+                if (keep(i)) storeInsert(slots[i].key, slots[i].geo);
+            }
+        }
+
+        if (slots[i].geo)
+        {
+            recordHit(evalId, plan[i].node, slots[i].geo.get());
+            continue;
+        }
+
+        ++toResolve;
+        for (size_t idx : plan[i].inputs)
+            if (idx != npos) needed[idx] = 1;
+    }
+
+    // Bucket what's left to cook by level: everything within a level is independent.
+    int maxLevel = 0;
+    for (size_t i = 0; i < plan.size(); ++i)
+        if (needed[i] && !slots[i].geo) maxLevel = std::max(maxLevel, plan[i].level);
+
+    std::vector<std::vector<size_t>> levels(size_t(maxLevel) + 1);
+    for (size_t i = 0; i < plan.size(); ++i)
+        if (needed[i] && !slots[i].geo) levels[size_t(plan[i].level)].push_back(i);
+
+    // What the SOPs see: the caller's cancel token, the cooker's pool, and
+    // per-node progress folded into the caller's overall progress.
+    std::unique_ptr<ProgressTracker> tracker;
+    CookContext nodeCtx;
+    nodeCtx.cancel = ctx.cancel;
+    nodeCtx.pool = m_pool.get();
+    nodeCtx.preview = ctx.preview;
+    nodeCtx.frame = ctx.frame;
+    nodeCtx.fps = ctx.fps;
+    if (ctx.progress && toResolve)
+    {
+        tracker = std::make_unique<ProgressTracker>(ctx, toResolve);
+        nodeCtx.progress = [t = tracker.get()](float f) { t->nodeProgress(f); };
+    }
+
+    for (const auto& level : levels)
+    {
+        if (ctx.cancelled()) return {};
+
+        // Nodes that share a key (duplicated branches) are cooked once, by the
+        // first of them.
+        std::vector<size_t> toCook;
+        std::unordered_map<uint64_t, size_t> owner;
+        for (size_t i : level)
+            if (owner.emplace(slots[i].key, i).second) toCook.push_back(i);
+
+        // Cook (outside the lock: this is the part that runs concurrently)
+        if (m_pool && toCook.size() > 1)
+        {
+            m_pool->parallelFor(toCook.size(), 1, [&](size_t begin, size_t end)
+            {
+                for (size_t k = begin; k < end; ++k)
+                {
+                    produce(plan[toCook[k]], slots, slots[toCook[k]], nodeCtx, evalId);
+                    if (tracker) tracker->nodeDone();
+                }
+            });
+        }
+        else
+        {
+            for (size_t i : toCook)
+            {
+                produce(plan[i], slots, slots[i], nodeCtx, evalId);
+                if (tracker) tracker->nodeDone();
+            }
+        }
+
+        // A cancelled SOP returns whatever it had so far, and skipped cooks left
+        // holes: drop the whole level and the rest of the chain, cache nothing.
+        if (ctx.cancelled()) return {};
+
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_stats.misses += toCook.size();
+        for (size_t i : toCook)
+        {
+            if (keep(i)) storeInsert(slots[i].key, slots[i].geo);
+            // previews are superseded within the second; not worth the disk traffic
+            if (m_disk && plan[i].node && !ctx.preview && m_disk->worthStoring(slots[i].cookMs))
+                m_disk->storeAsync(slots[i].key, slots[i].geo);
+        }
+        for (size_t i : level)
+        {
+            if (slots[i].geo) continue;
+            slots[i].geo = slots[owner[slots[i].key]].geo; // duplicate of a node cooked above
+            ++m_stats.hits;
+            recordHit(evalId, plan[i].node, slots[i].geo.get());
+            if (tracker) tracker->nodeDone();
+        }
+    }
+
+    // Intermediate results were pinned while this evaluation held them.
+    auto result = std::move(slots[root].geo);
+    slots.clear();
+    if (result) scope.event().bytes = result->byteSize();
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        evictToBudget();
+    }
+    return result;
+}
+
+size_t Cooker::buildPlan(NodeId root, std::vector<PlanNode>& plan) const
+{
+    if (!m_graph->get(root)) return npos;
 
-    std::vector<uint64_t> inputParamRevs;
-    inputParamRevs.reserve(inputIds.size());
+    // Iterative post-order DFS over inputs (graphs can be deep chains).
+    std::unordered_set<NodeId> seen;
+    std::unordered_map<NodeId, size_t> index;
 
-    for (NodeId inId : inputIds)
+    struct Frame { NodeId id; std::vector<NodeId> inputs; size_t next = 0; };
+    std::vector<Frame> stack;
+    stack.push_back({root, m_graph->inputsOf(root)});
+    seen.insert(root);
+
+    while (!stack.empty())
     {
-        const Node* inNode = m_graph->get(inId);
-        inputParamRevs.push_back(inNode ? inNode->paramRevision() : 0);
-        inputGeos.push_back(evaluateInternal(inId));
+        Frame& f = stack.back();
+        if (f.next < f.inputs.size())
+        {
+            const NodeId in = f.inputs[f.next++];
+            if (!seen.insert(in).second) continue; // done, or a cycle (left unresolved)
+            stack.push_back({in, m_graph->inputsOf(in)});
+            continue;
+        }
+
+        PlanNode pn;
+        pn.id = f.id;
+        pn.node = m_graph->get(f.id);
+        pn.inputs.reserve(f.inputs.size());
+        for (NodeId in : f.inputs)
+        {
+            auto it = index.find(in);
+            const size_t idx = (it == index.end()) ? npos : it->second;
+            pn.inputs.push_back(idx);
+            if (idx != npos) pn.level = std::max(pn.level, plan[idx].level + 1);
+        }
+
+        index[pn.id] = plan.size();
+        plan.push_back(std::move(pn));
+        stack.pop_back();
     }
 
-    // Cache check
-    auto it = m_cache.find(nodeId);
-    if (it != m_cache.end())
+    return index[root];
+}
+
+void Cooker::keyPlan(const std::vector<PlanNode>& plan, std::vector<Slot>& slots, const CookContext& ctx)
+{
+    // hashParams may touch the filesystem (File stats its path): run it
+    // before taking the lock every cook thread and the HUD contend on.
+    std::vector<uint64_t> paramHashes(plan.size(), 0);
+    for (size_t i = 0; i < plan.size(); ++i)
     {
-        CacheEntry& e = it->second;
-        const bool topoOk = (e.topoRev == topoRev);
-        const bool paramOk = (e.paramRev == paramRev);
-        const bool inputsOk = (e.inputIds == inputIds && e.inputParamRevs == inputParamRevs);
+        if (!plan[i].node) continue;
+        Hasher h;
+        plan[i].node->hashParams(h);
+        paramHashes[i] = h.value();
+    }
+
+    // plan order puts inputs first
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    for (size_t i = 0; i < plan.size(); ++i)
+    {
+        slots[i].key = keyFor(plan[i], slots, paramHashes[i], ctx);
+        slots[i].varying = plan[i].node && plan[i].node->isTimeDependent();
+        for (size_t in : plan[i].inputs)
+            if (in != npos && slots[in].varying) slots[i].varying = true;
+    }
+}
+
+uint64_t Cooker::keyFor(const PlanNode& pn, const std::vector<Slot>& slots, uint64_t paramHash,
+                        const CookContext& ctx)
+{
+    if (!pn.node) return kEmptyKey;
 
-        if (topoOk && paramOk && inputsOk && e.geo)
-            return e.geo;
+    std::vector<uint64_t> inputKeys;
+    inputKeys.reserve(pn.inputs.size());
+    for (size_t idx : pn.inputs)
+        inputKeys.push_back(idx == npos ? kEmptyKey : slots[idx].key);
+
+    // Content, not an edit counter: whoever wrote the parameters, and however,
+    // an unchanged block keeps its key and a changed one gets a new one.
+    // paramHash comes from hashParams on every keying, so state outside the
+    // block, like a File's size and mtime, is noticed as well.
+    const bool preview = ctx.preview && pn.node->hasPreview();
+    // Static nodes ignore the frame, so one result serves them all.
+    const bool timed = pn.node->isTimeDependent();
+    const double time = timed ? ctx.time() : 0.0;
+
+    auto it = m_cache.find(pn.id);
+    if (it != m_cache.end() && it->second.paramHash == paramHash && it->second.preview == preview
+        && it->second.timed == timed && it->second.time == time && it->second.inputKeys == inputKeys)
+        return it->second.key;
+
+    Hasher h;
+    h.add(pn.node->typeName()).add(paramHash);
+    // downstream keys differ through their input keys
+    if (preview) h.add("preview");
+    if (timed)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &time, sizeof(bits));
+        h.add("time").add(bits);
     }
+    h.add(uint64_t(inputKeys.size()));
+    for (uint64_t k : inputKeys) h.add(k);
 
-    // Cook
-    CookContext ctx;
-    Geometry out = node->cook(ctx, inputGeos);
-    auto shared = std::make_shared<Geometry>(std::move(out));
+    CacheEntry& e = m_cache[pn.id];
+    e.key = h.value();
+    e.paramHash = paramHash;
+    e.preview = preview;
+    e.timed = timed;
+    e.time = time;
+    e.inputKeys = std::move(inputKeys);
+    return e.key;
+}
 
-    CacheEntry entry;
-    entry.geo = shared;
-    entry.topoRev = topoRev;
-    entry.paramRev = paramRev;
-    entry.inputIds = inputIds;
-    entry.inputParamRevs = inputParamRevs;
-    m_cache[nodeId] = std::move(entry);
+void Cooker::produce(const PlanNode& pn, const std::vector<Slot>& slots, Slot& slot,
+                     const CookContext& ctx, uint64_t evalId) const
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    slot.geo = cookPlanNode(pn, slots, ctx, evalId);
+    slot.cookMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
 
-    return shared;
-}
\ No newline at end of file
+std::shared_ptr<const Geometry> Cooker::cookPlanNode(const PlanNode& pn, const std::vector<Slot>& slots,
+                                                     const CookContext& ctx, uint64_t evalId) const
+{
+    if (ctx.cancelled()) return {};
+    if (!pn.node) return std::make_shared<Geometry>();
+
+    std::vector<std::shared_ptr<const Geometry>> inputGeos;
+    inputGeos.reserve(pn.inputs.size());
+    for (size_t idx : pn.inputs)
+        inputGeos.push_back(idx == npos ? std::make_shared<Geometry>() : slots[idx].geo);
+
+    ProfileScope scope(ProfileKind::Cook, pn.node->name());
+    scope.event().evalId = evalId;
+    scope.event().node = pn.id;
+
+    Geometry out = pn.node->cook(ctx, inputGeos);
+    if (ctx.cancelled()) return {}; // possibly partial: never let it near the store
+    if (Profiler::instance().enabled()) scope.event().bytes = producedBytes(out, inputGeos);
+    return std::make_shared<Geometry>(std::move(out));
+}
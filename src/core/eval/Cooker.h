@@ -1,31 +1,231 @@
 #pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include "core/graph/Graph.h"
 
+class DiskCache;
+class ThreadPool;
+
+// Per-node memo of the node's content key. paramHash and the input keys are
+// recomputed on every keying; when they (and the preview/time inputs) match,
+// the memo only saves hashing them into the final key.
 struct CacheEntry
 {
-    std::shared_ptr<const Geometry> geo;
-    uint64_t topoRev = 0;
-    uint64_t paramRev = 0;
-    std::vector<uint64_t> inputParamRevs; // simplistic (per input node param rev)
-    std::vector<NodeId> inputIds;         // to match above
+    uint64_t key = 0;               // hash of type, params and input keys (Merkle-style)
+    uint64_t paramHash = 0;         // Node::hashParams() the key was made with
+    bool preview = false;           // keyed as a preview cook (CookContext::preview)
+    bool timed = false;             // keyed by time (Node::isTimeDependent)
+    double time = 0.0;
+    std::vector<uint64_t> inputKeys;
+};
+
+struct CacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;     // each one a cook
+    uint64_t diskHits = 0;   // store misses served by the disk cache instead of a cook
+    uint64_t evictions = 0;
+    size_t bytes = 0;        // buffer bytes held by the store (shared buffers counted once)
+    size_t budgetBytes = 0;  // 0 = unlimited
+    size_t entries = 0;
+};
+
+// Result of Cooker::evaluateAsync. Copyable; all copies share one request.
+class CookHandle
+{
+public:
+    bool valid() const { return m_future.valid(); }
+    bool ready() const;
+
+    // Blocks until the cook finishes. Null if it was cancelled or superseded.
+    std::shared_ptr<const Geometry> get() const { return m_future.get(); }
+
+    void cancel() { if (m_token) m_token->cancel(); }
+
+private:
+    friend class Cooker;
+    std::shared_future<std::shared_ptr<const Geometry>> m_future;
+    std::shared_ptr<CancelToken> m_token;
+};
+
+// Per-request settings of an async cook, copied into its CookContext.
+struct CookOptions
+{
+    bool preview = false; // cheap interactive cook; see Node::hasPreview()
+    int frame = 1;
+    double fps = 24.0;
+};
+
+enum class CookMode
+{
+    Serial,   // everything on the calling thread
+    Parallel  // independent branches cooked concurrently on a thread pool
 };
 
 class Cooker
 {
 public:
-    explicit Cooker(const Graph* g) : m_graph(g) {}
+    // threadCount only applies to CookMode::Parallel (0 = one per hardware thread)
+    explicit Cooker(const Graph* g, CookMode mode = CookMode::Serial, unsigned threadCount = 0);
+    ~Cooker();
+
+    // Cooks on the calling thread. Returns null only if ctx was cancelled;
+    // nothing a cancelled cook produced is cached. ctx.progress, if set,
+    // receives the fraction of the whole evaluation done.
+    std::shared_ptr<const Geometry> evaluate(NodeId nodeId, const CookContext& ctx = {});
 
-    std::shared_ptr<const Geometry> evaluate(NodeId nodeId);
+    using CookCallback = std::function<void(std::shared_ptr<const Geometry>)>;
+    using ProgressCallback = std::function<void(float)>;
 
-    void clearCache() { m_cache.clear(); }
+    // Cooks on the cooker's background thread. The newest request wins: any
+    // request still queued or running is cancelled. onDone (optional) runs on
+    // the background thread with the result, or null when cancelled;
+    // onProgress (optional) receives the fraction of the whole evaluation done.
+    CookHandle evaluateAsync(NodeId nodeId, CookCallback onDone = {}, ProgressCallback onProgress = {},
+                             CookOptions options = {});
+
+    // Cancel every async request and wait until the background thread is idle.
+    // Call before editing the graph or node parameters while cooks may be in flight.
+    void interrupt();
+
+    using FrameCallback = std::function<void(int frame, std::shared_ptr<const Geometry>)>;
+
+    // Batch/farm: cooks nodeId at every frame in [first, last], handing each
+    // result to onFrame as it lands (on pool threads, in no particular order).
+    // Static upstream branches cook once and are shared by every frame; only
+    // the time-dependent part cooks per frame, up to maxInFlight frames at a
+    // time (0 = one per pool thread). Per-frame results are not kept in the
+    // store, so memory is bounded by the frames in flight, not the range.
+    // Uses ctx's cancel, fps and progress (fraction of frames done). False if
+    // cancelled; frames already handed out stay handed out.
+    bool cookFrames(NodeId nodeId, int first, int last, const FrameCallback& onFrame,
+                    const CookContext& ctx = {}, unsigned maxInFlight = 0);
+
+    // Playback: cook `frames` of nodeId (in that order) on background threads
+    // so they are already in the store when they come up. Calling again for
+    // the same node and fps only replaces the frames still waiting; frames
+    // being cooked finish. interrupt() stops it, like any other cook.
+    void prefetch(NodeId nodeId, std::vector<int> frames, double fps = 24.0);
+    void stopPrefetch(); // cancels and waits for the prefetch threads
+
+    // Forget the memoised keys of nodeId and everything downstream of it.
+    // Cooked geometry stays in the store, so reverting an edit is still a hit.
+    void markDirty(NodeId nodeId);
+
+    void clearCache();
+
+    // Cap on bytes held by the geometry store (0 = unlimited). Least recently
+    // used results are evicted past it; results still referenced elsewhere
+    // (e.g. the geometry on screen) are never dropped, so the cap is soft.
+    void setCacheBudget(size_t bytes);
+    size_t cacheBudget() const { return m_budget; }
+
+    CacheStats cacheStats() const;
+
+    // Optional second tier: store misses are looked up here before anything
+    // upstream is cooked, and results of slow cooks are written back. May be shared between
+    // cookers. Set while no cook is running (null = memory only).
+    void setDiskCache(std::shared_ptr<DiskCache> disk);
+    const std::shared_ptr<DiskCache>& diskCache() const { return m_disk; }
+
+    CookMode mode() const { return m_mode; }
 
 private:
+    // One node of the subgraph reachable from the evaluated node.
+    struct PlanNode
+    {
+        NodeId id = 0;
+        const Node* node = nullptr;
+        std::vector<size_t> inputs; // plan indices (npos = missing/cyclic)
+        int level = 0;              // 0 = no inputs; otherwise 1 + max input level
+    };
+
+    struct Slot
+    {
+        uint64_t key = 0;
+        std::shared_ptr<const Geometry> geo;
+        double cookMs = 0; // time spent cooking it, if it was cooked
+        bool varying = false; // changes with the frame: time dependent itself or upstream
+    };
+
     const Graph* m_graph = nullptr;
+    CookMode m_mode = CookMode::Serial;
+    std::unique_ptr<ThreadPool> m_pool;
+    std::shared_ptr<DiskCache> m_disk;
+
+    struct StoreEntry
+    {
+        std::shared_ptr<const Geometry> geo;
+        std::list<uint64_t>::iterator lru;
+    };
+
+    struct AsyncJob
+    {
+        NodeId node = 0;
+        CookOptions options;
+        std::shared_ptr<CancelToken> token;
+        std::promise<std::shared_ptr<const Geometry>> promise;
+        CookCallback onDone;
+        ProgressCallback onProgress;
+    };
+
+    // background cook thread (started on first evaluateAsync)
+    std::thread m_worker;
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobCv;
+    std::deque<AsyncJob> m_jobs;
+    std::shared_ptr<CancelToken> m_runningToken; // job being cooked, if any
+    bool m_stopWorker = false;
+
+    // playback prefetch (see prefetch())
+    std::mutex m_prefetchMutex;
+    std::condition_variable m_prefetchCv;
+    std::deque<int> m_prefetchFrames;
+    std::set<int> m_prefetchCooking; // popped from m_prefetchFrames, still cooking
+    std::vector<std::thread> m_prefetchThreads;
+    std::shared_ptr<CancelToken> m_prefetchToken;
+    NodeId m_prefetchNode = 0;
+    double m_prefetchFps = 0.0;
+    bool m_stopPrefetch = false;
+
+    mutable std::mutex m_cacheMutex;
     std::unordered_map<NodeId, CacheEntry> m_cache;
+    std::unordered_map<uint64_t, StoreEntry> m_store; // content key -> geometry
+    std::list<uint64_t> m_lru;                        // most recently used first
+    std::unordered_map<const void*, size_t> m_bufferRefs; // store entries holding each buffer
+    size_t m_budget = 0;
+    CacheStats m_stats;
 
-    std::shared_ptr<const Geometry> evaluateInternal(NodeId nodeId);
-};
\ No newline at end of file
+    void workerLoop();
+    void prefetchLoop();
+    // Blocks while a prefetch thread is cooking the same frame of nodeId (or
+    // until ctx is cancelled); its result then waits in the store.
+    void waitForPrefetch(NodeId nodeId, const CookContext& ctx);
+    bool inStore(NodeId nodeId, const CookContext& ctx);
+    // storeVarying = false: results that change with the frame are used once
+    // and not kept in the store (cookFrames).
+    std::shared_ptr<const Geometry> evaluateImpl(NodeId nodeId, const CookContext& ctx, bool storeVarying);
+    size_t buildPlan(NodeId root, std::vector<PlanNode>& plan) const;
+    std::shared_ptr<const Geometry> storeFind(uint64_t key);
+    void storeInsert(uint64_t key, std::shared_ptr<const Geometry> geo);
+    void storeErase(std::unordered_map<uint64_t, StoreEntry>::iterator it);
+    void evictToBudget();
+    // Keys every slot (and sets varying); takes m_cacheMutex itself.
+    void keyPlan(const std::vector<PlanNode>& plan, std::vector<Slot>& slots, const CookContext& ctx);
+    uint64_t keyFor(const PlanNode& pn, const std::vector<Slot>& slots, uint64_t paramHash,
+                    const CookContext& ctx);
+    void produce(const PlanNode& pn, const std::vector<Slot>& slots, Slot& slot,
+                 const CookContext& ctx, uint64_t evalId) const;
+    std::shared_ptr<const Geometry> cookPlanNode(const PlanNode& pn, const std::vector<Slot>& slots,
+                                                 const CookContext& ctx, uint64_t evalId) const;
+};
@@ -0,0 +1,202 @@
+#include "core/eval/DiskCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#include "core/geo/Geometry.h"
+#include "core/io/GeoFile.h"
+#include "core/util/Hash.h"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Bump when cook results for the same key could change (e.g. a SOP's
+    // output changes without its parameters changing): orphans every old file.
+    constexpr uint64_t kCacheVersion = 1;
+
+    struct CachedFile
+    {
+        fs::path path;
+        fs::file_time_type mtime;
+        uintmax_t size;
+    };
+
+    std::vector<CachedFile> scan(const std::string& dir)
+    {
+        std::vector<CachedFile> files;
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+        {
+            if (it->path().extension() != ".hgeo") continue;
+            std::error_code fe;
+            const auto size = it->file_size(fe);
+            const auto mtime = it->last_write_time(fe);
+            if (!fe) files.push_back({it->path(), mtime, size});
+        }
+        return files;
+    }
+}
+
+DiskCache::DiskCache(std::string directory, DiskCacheOptions options)
+    : m_dir(std::move(directory))
+    , m_options(options)
+{
+    std::error_code ec;
+    fs::create_directories(m_dir, ec);
+    m_valid = fs::is_directory(m_dir, ec);
+    if (!m_valid) return;
+
+    for (const CachedFile& f : scan(m_dir)) m_stats.bytes += size_t(f.size);
+    m_writer = std::thread([this]() { writerLoop(); });
+}
+
+DiskCache::~DiskCache()
+{
+    if (!m_writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_writer.join();
+}
+
+std::string DiskCache::pathFor(uint64_t key) const
+{
+    char name[32];
+    const uint64_t k = Hasher().add(kCacheVersion).add(key).value();
+    std::snprintf(name, sizeof(name), "%016llx.hgeo", (unsigned long long)k);
+    return (fs::path(m_dir) / name).string();
+}
+
+std::shared_ptr<const Geometry> DiskCache::load(uint64_t key)
+{
+    if (!m_valid) return {};
+
+    const std::string path = pathFor(key);
+    auto geo = std::make_shared<Geometry>();
+    std::string error;
+    const bool ok = readGeo(path, *geo, error);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!ok)
+    {
+        ++m_stats.misses;
+        return {};
+    }
+    ++m_stats.hits;
+
+    // keep it young for trim(); fails harmlessly on a read-only share
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return geo;
+}
+
+void DiskCache::storeAsync(uint64_t key, std::shared_ptr<const Geometry> geo)
+{
+    if (!m_valid || !geo) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pending.size() >= m_options.maxPendingWrites) return;
+        m_pending.emplace_back(key, std::move(geo));
+    }
+    m_cv.notify_all();
+}
+
+void DiskCache::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_pending.empty() && !m_writing; });
+}
+
+void DiskCache::clear()
+{
+    flush();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const CachedFile& f : scan(m_dir))
+    {
+        std::error_code ec;
+        fs::remove(f.path, ec);
+    }
+    m_stats.bytes = 0;
+}
+
+DiskCacheStats DiskCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void DiskCache::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_cv.wait(lock, [this]() { return m_stop || !m_pending.empty(); });
+        if (m_pending.empty()) return; // stopping, queue drained
+
+        auto [key, geo] = std::move(m_pending.front());
+        m_pending.pop_front();
+        m_writing = true;
+        lock.unlock();
+
+        // Another session (or machine) may have written it already.
+        const std::string path = pathFor(key);
+        std::error_code ec;
+        bool wrote = false;
+        uintmax_t size = 0;
+        if (!fs::exists(path, ec))
+        {
+            std::string error;
+            wrote = writeGeo(*geo, path, error, {});
+            if (wrote) size = fs::file_size(path, ec);
+        }
+        geo.reset();
+
+        lock.lock();
+        if (wrote)
+        {
+            ++m_stats.writes;
+            m_stats.bytes += size_t(size);
+        }
+        const bool over = m_options.maxBytes && m_stats.bytes > m_options.maxBytes;
+        lock.unlock();
+
+        if (over) trim();
+
+        lock.lock();
+        m_writing = false;
+        m_cv.notify_all(); // wake flush()
+    }
+}
+
+void DiskCache::trim()
+{
+    // Rescan rather than trust our count: other processes share the directory.
+    std::vector<CachedFile> files = scan(m_dir);
+    size_t bytes = 0;
+    for (const CachedFile& f : files) bytes += size_t(f.size);
+
+    // Oldest first, down to 90% so we don't trim again on the next write.
+    std::sort(files.begin(), files.end(),
+              [](const CachedFile& a, const CachedFile& b) { return a.mtime < b.mtime; });
+    const size_t target = m_options.maxBytes / 10 * 9;
+    uint64_t evicted = 0;
+    for (const CachedFile& f : files)
+    {
+        if (bytes <= target) break;
+        std::error_code ec;
+        if (fs::remove(f.path, ec))
+        {
+            bytes -= size_t(f.size);
+            ++evicted;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytes = bytes;
+    m_stats.evictions += evicted;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+struct Geometry;
+
+struct DiskCacheOptions
+{
+    size_t maxBytes = size_t(4) << 30; // 0 = unlimited
+    double minCookMs = 5.0;            // cheaper cooks are recooked rather than written
+    size_t maxPendingWrites = 16;      // further stores are dropped while the writer is behind
+};
+
+struct DiskCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t writes = 0;
+    uint64_t evictions = 0;
+    size_t bytes = 0; // on disk, as of the last scan plus our own writes
+};
+
+// Second cache tier behind Cooker's in-memory store: cooked geometry as
+// .hgeo files named by the cook's content key, so results survive restarts
+// and can be shared by every process (or machine) pointed at the same
+// directory. Loads are mapped, so a hit costs about as much as an open().
+//
+// Files are written whole and renamed into place; readers never see a
+// partial one. Least recently used files (by mtime, which a hit refreshes)
+// are deleted once the directory grows past maxBytes.
+class DiskCache
+{
+public:
+    explicit DiskCache(std::string directory, DiskCacheOptions options = {});
+    ~DiskCache(); // finishes queued writes
+
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
+
+    const std::string& directory() const { return m_dir; }
+    bool valid() const { return m_valid; } // false if the directory couldn't be created
+
+    // Null on a miss or an unreadable file.
+    std::shared_ptr<const Geometry> load(uint64_t key);
+
+    bool worthStoring(double cookMs) const { return m_valid && cookMs >= m_options.minCookMs; }
+
+    // Queues geo for the writer thread. Geometry is immutable once cooked, so
+    // the queue just holds a reference.
+    void storeAsync(uint64_t key, std::shared_ptr<const Geometry> geo);
+
+    void flush(); // blocks until queued writes are on disk
+    void clear(); // deletes every cached file
+
+    DiskCacheStats stats() const;
+
+private:
+    std::string pathFor(uint64_t key) const;
+    void writerLoop();
+    void trim(); // called by the writer only
+
+    std::string m_dir;
+    DiskCacheOptions m_options;
+    bool m_valid = false;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::pair<uint64_t, std::shared_ptr<const Geometry>>> m_pending;
+    bool m_writing = false;
+    bool m_stop = false;
+    DiskCacheStats m_stats;
+    std::thread m_writer;
+};
@@ -0,0 +1,160 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Attribute buffers are 32-byte aligned so kernels can use aligned SSE/AVX loads.
+constexpr size_t kAttribAlignment = 32;
+
+template <class T>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <class U> AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kAttribAlignment)));
+    }
+    void deallocate(T* p, size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t(kAttribAlignment));
+    }
+
+    // Default-insert leaves trivial types uninitialised: resize(n) on a buffer
+    // about to be overwritten shouldn't page in a zero fill first. Pass an
+    // explicit value (resize(n, 0)) when zeros are wanted.
+    template <class U> void construct(U* p) noexcept
+    {
+        // Plain aggregates like Tri are implicit-lifetime types: the storage
+        // already holds them, so skip their member initialisers too.
+        if constexpr (!(std::is_aggregate_v<U> && std::is_trivially_copyable_v<U>))
+            ::new (static_cast<void*>(p)) U;
+    }
+    template <class U, class... Args> void construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class U> bool operator==(const AlignedAllocator<U>&) const noexcept { return true; }
+};
+
+template <class T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Reference-counted array shared copy-on-write: copying is O(1), and the
+// first mutable access to a shared array clones it. Const access never copies.
+//
+// An array can also be a read-only view of memory owned elsewhere (e.g. a
+// mapped geometry file, see external()); the owner is kept alive by the view
+// and the first mutable access copies the elements into owned storage.
+template <class T>
+class CowArray
+{
+public:
+    CowArray() = default;
+    explicit CowArray(size_t n, const T& fill = T{})
+        : m_data(std::make_shared<AlignedVector<T>>(n, fill)) {}
+
+    // Zero-copy view of n elements at p, kept valid by owner.
+    static CowArray external(const T* p, size_t n, std::shared_ptr<const void> owner)
+    {
+        CowArray a;
+        a.m_ext = p;
+        a.m_extSize = n;
+        a.m_extOwner = std::move(owner);
+        return a;
+    }
+
+    size_t size() const { return m_ext ? m_extSize : m_data ? m_data->size() : 0; }
+    bool empty() const { return size() == 0; }
+
+    const T* data() const { return m_ext ? m_ext : m_data ? m_data->data() : nullptr; }
+    const T& operator[](size_t i) const { return data()[i]; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+
+    // Detaches (copies) if shared or external.
+    T* mutableData()
+    {
+        detach();
+        return m_data ? m_data->data() : nullptr;
+    }
+
+    // Unshared storage of n elements without copying the old contents;
+    // for kernels that overwrite every element.
+    T* overwrite(size_t n)
+    {
+        dropExternal();
+        if (!m_data || m_data.use_count() > 1) m_data = std::make_shared<AlignedVector<T>>(n);
+        else m_data->resize(n);
+        return m_data->data();
+    }
+
+    void resize(size_t n, const T& fill = T{})
+    {
+        if (n == size()) return;
+        detach(n);
+        m_data->resize(n, fill);
+    }
+
+    void reserve(size_t n)
+    {
+        detach(n);
+        m_data->reserve(n);
+    }
+
+    // Same identity = same storage (shared between geometries).
+    const void* identity() const { return m_ext ? static_cast<const void*>(m_ext) : m_data.get(); }
+    bool shared() const { return m_ext || (m_data && m_data.use_count() > 1); }
+    bool isExternal() const { return m_ext != nullptr; }
+    size_t capacityBytes() const
+    {
+        return m_ext ? m_extSize * sizeof(T) : m_data ? m_data->capacity() * sizeof(T) : 0;
+    }
+
+private:
+    std::shared_ptr<AlignedVector<T>> m_data;
+
+    const T* m_ext = nullptr;
+    size_t m_extSize = 0;
+    std::shared_ptr<const void> m_extOwner;
+
+    void dropExternal()
+    {
+        m_ext = nullptr;
+        m_extSize = 0;
+        m_extOwner.reset();
+    }
+
+    void detach(size_t reserveHint = 0)
+    {
+        if (m_ext)
+        {
+            auto copy = std::make_shared<AlignedVector<T>>();
+            copy->reserve(std::max(reserveHint, m_extSize));
+            copy->assign(m_ext, m_ext + m_extSize);
+            m_data = std::move(copy);
+            dropExternal();
+            return;
+        }
+        if (!m_data)
+        {
+            m_data = std::make_shared<AlignedVector<T>>();
+            m_data->reserve(reserveHint);
+            return;
+        }
+        if (m_data.use_count() == 1) return;
+
+        auto copy = std::make_shared<AlignedVector<T>>();
+        copy->reserve(std::max(reserveHint, m_data->size()));
+        copy->assign(m_data->begin(), m_data->end());
+        m_data = std::move(copy);
+    }
+};
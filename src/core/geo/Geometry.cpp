@@ -1 +1,171 @@
-#include "core/geo/Geometry.h"
\ No newline at end of file
+#include "core/geo/Geometry.h"
+
+#include <algorithm>
+
+Attribute::Attribute(std::string name, AttribType type, int tupleSize, size_t count)
+    : m_name(std::move(name))
+    , m_type(type)
+    , m_tupleSize(tupleSize < 1 ? 1 : tupleSize)
+{
+    if (m_type == AttribType::Float) m_floats.resize(size_t(m_tupleSize));
+    else m_ints.resize(size_t(m_tupleSize));
+    resize(count);
+}
+
+void Attribute::resize(size_t n)
+{
+    if (n == m_size) return; // don't detach shared buffers for nothing
+    for (auto& c : m_floats) c.resize(n, 0.0f);
+    for (auto& c : m_ints) c.resize(n, 0);
+    m_size = n;
+}
+
+void Attribute::overwrite(size_t n)
+{
+    for (auto& c : m_floats) c.overwrite(n);
+    for (auto& c : m_ints) c.overwrite(n);
+    m_size = n;
+}
+
+void Attribute::setBuffer(int comp, CowArray<float> buf)
+{
+    m_size = buf.size();
+    m_floats[size_t(comp)] = std::move(buf);
+}
+
+void Attribute::setBuffer(int comp, CowArray<int32_t> buf)
+{
+    m_size = buf.size();
+    m_ints[size_t(comp)] = std::move(buf);
+}
+
+void Attribute::reserve(size_t n)
+{
+    for (auto& c : m_floats) c.reserve(n);
+    for (auto& c : m_ints) c.reserve(n);
+}
+
+void AttribTable::resize(size_t n)
+{
+    for (auto& a : m_attribs) a.resize(n);
+    m_size = n;
+}
+
+void AttribTable::overwrite(size_t n)
+{
+    for (auto& a : m_attribs) a.overwrite(n);
+    m_size = n;
+}
+
+void AttribTable::reserve(size_t n)
+{
+    for (auto& a : m_attribs) a.reserve(n);
+}
+
+Attribute* AttribTable::find(std::string_view name)
+{
+    for (auto& a : m_attribs)
+        if (a.name() == name) return &a;
+    return nullptr;
+}
+
+const Attribute* AttribTable::find(std::string_view name) const
+{
+    for (auto& a : m_attribs)
+        if (a.name() == name) return &a;
+    return nullptr;
+}
+
+Attribute& AttribTable::add(std::string name, AttribType type, int tupleSize)
+{
+    if (Attribute* a = find(name))
+    {
+        if (a->type() == type && a->tupleSize() == tupleSize) return *a;
+        *a = Attribute(std::move(name), type, tupleSize, m_size);
+        return *a;
+    }
+    m_attribs.emplace_back(std::move(name), type, tupleSize, m_size);
+    return m_attribs.back();
+}
+
+bool AttribTable::insert(Attribute a)
+{
+    if (m_attribs.empty()) m_size = a.size();
+    else if (a.size() != m_size) return false;
+
+    if (Attribute* existing = find(a.name())) *existing = std::move(a);
+    else m_attribs.push_back(std::move(a));
+    return true;
+}
+
+bool AttribTable::remove(std::string_view name)
+{
+    auto it = std::find_if(m_attribs.begin(), m_attribs.end(),
+                           [name](const Attribute& a){ return a.name() == name; });
+    if (it == m_attribs.end()) return false;
+    m_attribs.erase(it);
+    return true;
+}
+
+Geometry::Geometry()
+{
+    pointAttribs.add("P", AttribType::Float, 3);
+    detailAttribs.resize(1);
+}
+
+void Geometry::resizePrims(size_t n)
+{
+    Tris.resize(n);
+    primAttribs.resize(n);
+    vertexAttribs.resize(n * 3);
+}
+
+Tri* Geometry::overwritePrims(size_t n)
+{
+    primAttribs.resize(n);
+    vertexAttribs.resize(n * 3);
+    return Tris.overwrite(n);
+}
+
+Vec3 Geometry::point(size_t i) const
+{
+    const Attribute& p = P();
+    return { p.floats(0)[i], p.floats(1)[i], p.floats(2)[i] };
+}
+
+void Geometry::setPoint(size_t i, const Vec3& v)
+{
+    Attribute& p = P();
+    p.floats(0)[i] = v.x;
+    p.floats(1)[i] = v.y;
+    p.floats(2)[i] = v.z;
+}
+
+AttribTable& Geometry::table(AttribClass c)
+{
+    switch (c)
+    {
+        case AttribClass::Point:  return pointAttribs;
+        case AttribClass::Prim:   return primAttribs;
+        case AttribClass::Vertex: return vertexAttribs;
+        case AttribClass::Detail: break;
+    }
+    return detailAttribs;
+}
+
+const AttribTable& Geometry::table(AttribClass c) const
+{
+    return const_cast<Geometry*>(this)->table(c);
+}
+
+void Geometry::clear()
+{
+    *this = Geometry();
+}
+
+size_t Geometry::byteSize() const
+{
+    size_t bytes = sizeof(Geometry);
+    forEachBuffer([&bytes](const void*, size_t n) { bytes += n; });
+    return bytes;
+}
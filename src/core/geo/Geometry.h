@@ -1,6 +1,11 @@
 #pragma once
 #include <vector>
+#include <cstddef>
 #include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "core/geo/CowArray.h"
 
 struct Vec3
 {
@@ -12,11 +17,146 @@ struct Tri
     uint32_t a=0, b=0, c=0;
 };
 
+enum class AttribClass : uint8_t
+{
+    Point,
+    Prim,    // one per triangle
+    Vertex,  // one per triangle corner
+    Detail   // one for the whole geometry
+};
+
+enum class AttribType : uint8_t
+{
+    Float,
+    Int
+};
+
+// A named attribute stored structure-of-arrays: each component of the tuple
+// is its own contiguous buffer, so a kernel can stream just the X column.
+// Component buffers are copy-on-write: copying a Geometry shares them, and
+// the non-const accessors detach (copy) a shared buffer before handing it out.
+class Attribute
+{
+public:
+    Attribute(std::string name, AttribType type, int tupleSize, size_t count = 0);
+
+    const std::string& name() const { return m_name; }
+    AttribType type() const { return m_type; }
+    int tupleSize() const { return m_tupleSize; }
+    size_t size() const { return m_size; }
+
+    // Component buffers; must match type().
+    const float* floats(int comp) const { return m_floats[size_t(comp)].data(); }
+    const int32_t* ints(int comp) const { return m_ints[size_t(comp)].data(); }
+    float* floats(int comp) { return m_floats[size_t(comp)].mutableData(); }
+    int32_t* ints(int comp) { return m_ints[size_t(comp)].mutableData(); }
+
+    // Fresh unshared buffer with unspecified contents, for writing every element.
+    float* overwriteFloats(int comp) { return m_floats[size_t(comp)].overwrite(m_size); }
+    int32_t* overwriteInts(int comp) { return m_ints[size_t(comp)].overwrite(m_size); }
+
+    const CowArray<float>& floatBuffer(int comp) const { return m_floats[size_t(comp)]; }
+    const CowArray<int32_t>& intBuffer(int comp) const { return m_ints[size_t(comp)]; }
+
+    // Adopt an existing buffer (shared or external) as a component. Sets
+    // size() to the buffer's; every component must end up the same size.
+    void setBuffer(int comp, CowArray<float> buf);
+    void setBuffer(int comp, CowArray<int32_t> buf);
+
+    void resize(size_t n); // new elements are zero
+    void reserve(size_t n);
+    void overwrite(size_t n); // drop contents: n unshared elements, unspecified values
+
+    // Calls f(identity, bytes) for each component buffer.
+    template <class F> void forEachBuffer(F&& f) const
+    {
+        for (auto& c : m_floats) f(c.identity(), c.capacityBytes());
+        for (auto& c : m_ints) f(c.identity(), c.capacityBytes());
+    }
+
+private:
+    std::string m_name;
+    AttribType m_type;
+    int m_tupleSize;
+    size_t m_size = 0;
+
+    std::vector<CowArray<float>> m_floats;  // [component][element]
+    std::vector<CowArray<int32_t>> m_ints;
+};
+
+// All attributes of one class; every attribute has the table's element count.
+class AttribTable
+{
+public:
+    size_t size() const { return m_size; }
+    void resize(size_t n);
+    void reserve(size_t n);
+    void overwrite(size_t n); // every attribute: n unshared elements, unspecified values
+
+    Attribute* find(std::string_view name);
+    const Attribute* find(std::string_view name) const;
+
+    // Returns the existing attribute if name/type/tuple size match, otherwise
+    // replaces it. New attributes are zero-filled to size().
+    Attribute& add(std::string name, AttribType type, int tupleSize);
+    // Adds (or replaces by name) a ready-made attribute. The first attribute
+    // of an empty table sets its size; later ones must match it.
+    bool insert(Attribute a);
+    bool remove(std::string_view name);
+
+    const std::vector<Attribute>& attributes() const { return m_attribs; }
+    std::vector<Attribute>& attributes() { return m_attribs; }
+
+private:
+    std::vector<Attribute> m_attribs;
+    size_t m_size = 0;
+};
+
 struct Geometry
 {
-    std::vector<Vec3> P;      // point positions
-    std::vector<Tri>  Tris;   // triangle primitives
+    Geometry();
+
+    AttribTable pointAttribs;   // always holds "P" (float3)
+    AttribTable primAttribs;
+    AttribTable vertexAttribs;  // 3 * numPrims() elements, corner order a, b, c
+    AttribTable detailAttribs;  // always one element
 
-    bool empty() const { return P.empty() || Tris.empty(); }
-    void clear() { P.clear(); Tris.clear(); }
-};
\ No newline at end of file
+    CowArray<Tri> Tris;         // triangle primitives; resize via resizePrims()
+
+    size_t numPoints() const { return pointAttribs.size(); }
+    size_t numPrims() const { return Tris.size(); }
+
+    void resizePoints(size_t n) { pointAttribs.resize(n); }
+    void overwritePoints(size_t n) { pointAttribs.overwrite(n); } // caller fills every point attribute
+    void resizePrims(size_t n);
+    // resizePrims for SOPs that fill every triangle: unshared index buffer
+    // with unspecified contents (no zero fill, no copy).
+    Tri* overwritePrims(size_t n);
+
+    Attribute& P() { return *pointAttribs.find("P"); }
+    const Attribute& P() const { return *pointAttribs.find("P"); }
+
+    // Convenience (not for hot loops: go through P().floats(k) instead)
+    Vec3 point(size_t i) const;
+    void setPoint(size_t i, const Vec3& p);
+
+    AttribTable& table(AttribClass c);
+    const AttribTable& table(AttribClass c) const;
+
+    bool empty() const { return numPoints() == 0 || Tris.empty(); }
+    void clear();
+
+    // Calls f(identity, bytes) for every attribute and index buffer. Buffers
+    // shared with other geometries report the same identity.
+    template <class F> void forEachBuffer(F&& f) const
+    {
+        for (const AttribTable* t : {&pointAttribs, &primAttribs, &vertexAttribs, &detailAttribs})
+            for (const Attribute& a : t->attributes())
+                a.forEachBuffer(f);
+        f(Tris.identity(), Tris.capacityBytes());
+    }
+
+    // Buffer bytes reachable from this geometry (capacity, not size: that's
+    // what is resident), counting shared buffers in full.
+    size_t byteSize() const;
+};
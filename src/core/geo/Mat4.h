@@ -0,0 +1,55 @@
+#pragma once
+#include <cmath>
+
+#include "core/geo/Geometry.h"
+
+// Row-major affine 4x4, column-vector convention: p' = M * p.
+struct Mat4
+{
+    float m[4][4] = {{1,0,0,0}, {0,1,0,0}, {0,0,1,0}, {0,0,0,1}};
+
+    static Mat4 identity() { return {}; }
+
+    static Mat4 translate(const Vec3& t)
+    {
+        Mat4 r;
+        r.m[0][3] = t.x; r.m[1][3] = t.y; r.m[2][3] = t.z;
+        return r;
+    }
+
+    static Mat4 scale(const Vec3& s)
+    {
+        Mat4 r;
+        r.m[0][0] = s.x; r.m[1][1] = s.y; r.m[2][2] = s.z;
+        return r;
+    }
+
+    // axis: 0 = X, 1 = Y, 2 = Z
+    static Mat4 rotate(int axis, float degrees)
+    {
+        const float a = degrees * 3.14159265358979f / 180.0f;
+        const float c = std::cos(a), s = std::sin(a);
+        const int i = (axis + 1) % 3, j = (axis + 2) % 3;
+        Mat4 r;
+        r.m[i][i] = c; r.m[i][j] = -s;
+        r.m[j][i] = s; r.m[j][j] = c;
+        return r;
+    }
+
+    Mat4 operator*(const Mat4& b) const
+    {
+        Mat4 r;
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                r.m[i][j] = m[i][0] * b.m[0][j] + m[i][1] * b.m[1][j]
+                          + m[i][2] * b.m[2][j] + m[i][3] * b.m[3][j];
+        return r;
+    }
+
+    Vec3 transformPoint(const Vec3& p) const
+    {
+        return { m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3],
+                 m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3],
+                 m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3] };
+    }
+};
@@ -0,0 +1,245 @@
+#include "core/geo/PointKernels.h"
+
+// HS_FORCE_SCALAR (HYPERSPHERE_SIMD=SCALAR) compiles out the SIMD paths, for
+// debugging and bit-for-bit comparisons across machines.
+#if defined(HS_FORCE_SCALAR)
+  // scalar only
+#elif defined(__x86_64__) || defined(_M_X64)
+  #define HS_X86 1
+  #include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  #define HS_NEON 1
+  #include <arm_neon.h>
+#endif
+
+#if defined(HS_X86) && (defined(__GNUC__) || defined(__clang__))
+  #define HS_TARGET(isa) __attribute__((target(isa)))
+  #define HS_X86_DISPATCH 1
+#else
+  #define HS_TARGET(isa)
+#endif
+
+namespace
+{
+    using TransformFn = void (*)(const Mat4&, const float*, const float*, const float*,
+                                 float*, float*, float*, size_t, size_t);
+    using OffsetFn = void (*)(const uint32_t*, uint32_t*, size_t, size_t, uint32_t);
+
+    void offsetScalar(const uint32_t* src, uint32_t* dst, size_t begin, size_t n, uint32_t offset)
+    {
+        for (size_t i = begin; i < n; ++i) dst[i] = src[i] + offset;
+    }
+
+    // Elements [begin, n) - the vector paths finish their tails here.
+    // Every path computes ((m0*x + m1*y) + m2*z) + m3, unfused, in that order,
+    // so a point rounds the same whichever path (or machine) transforms it:
+    // disk-cached results are shared across machines. This file is built
+    // with FP contraction off so the compiler can't fuse it behind our back.
+    void transformScalar(const Mat4& M, const float* sx, const float* sy, const float* sz,
+                         float* dx, float* dy, float* dz, size_t begin, size_t n)
+    {
+        const auto& m = M.m;
+        for (size_t i = begin; i < n; ++i)
+        {
+            const float x = sx[i], y = sy[i], z = sz[i];
+            dx[i] = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3];
+            dy[i] = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3];
+            dz[i] = m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3];
+        }
+    }
+
+#if defined(HS_X86_DISPATCH)
+    HS_TARGET("avx2")
+    void transformAvx2(const Mat4& M, const float* sx, const float* sy, const float* sz,
+                       float* dx, float* dy, float* dz, size_t begin, size_t n)
+    {
+        const auto& m = M.m;
+        __m256 r[3][4];
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 4; ++j)
+                r[i][j] = _mm256_set1_ps(m[i][j]);
+
+        size_t i = begin;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(sx + i);
+            const __m256 y = _mm256_loadu_ps(sy + i);
+            const __m256 z = _mm256_loadu_ps(sz + i);
+
+            __m256 o[3];
+            for (int k = 0; k < 3; ++k)
+                o[k] = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[k][0], x),
+                                                                 _mm256_mul_ps(r[k][1], y)),
+                                                   _mm256_mul_ps(r[k][2], z)),
+                                     r[k][3]);
+
+            _mm256_storeu_ps(dx + i, o[0]);
+            _mm256_storeu_ps(dy + i, o[1]);
+            _mm256_storeu_ps(dz + i, o[2]);
+        }
+        // The tail runs as SSE code (and so does whatever this thread does next):
+        // clear the upper YMM halves first or every later SSE op pays for the transition.
+        _mm256_zeroupper();
+        transformScalar(M, sx, sy, sz, dx, dy, dz, i, n);
+    }
+
+    HS_TARGET("avx2")
+    void offsetAvx2(const uint32_t* src, uint32_t* dst, size_t begin, size_t n, uint32_t offset)
+    {
+        const __m256i o = _mm256_set1_epi32(int(offset));
+        size_t i = begin;
+        for (; i + 32 <= n; i += 32)
+        {
+            // 4 independent vectors per iteration to keep the load ports busy
+            const auto* s = reinterpret_cast<const __m256i*>(src + i);
+            auto* d = reinterpret_cast<__m256i*>(dst + i);
+            const __m256i a = _mm256_loadu_si256(s + 0);
+            const __m256i b = _mm256_loadu_si256(s + 1);
+            const __m256i c = _mm256_loadu_si256(s + 2);
+            const __m256i e = _mm256_loadu_si256(s + 3);
+            _mm256_storeu_si256(d + 0, _mm256_add_epi32(a, o));
+            _mm256_storeu_si256(d + 1, _mm256_add_epi32(b, o));
+            _mm256_storeu_si256(d + 2, _mm256_add_epi32(c, o));
+            _mm256_storeu_si256(d + 3, _mm256_add_epi32(e, o));
+        }
+        _mm256_zeroupper(); // see transformAvx2
+        offsetScalar(src, dst, i, n, offset);
+    }
+
+    HS_TARGET("sse4.1")
+    void offsetSse41(const uint32_t* src, uint32_t* dst, size_t begin, size_t n, uint32_t offset)
+    {
+        const __m128i o = _mm_set1_epi32(int(offset));
+        size_t i = begin;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi32(v, o));
+        }
+        offsetScalar(src, dst, i, n, offset);
+    }
+
+    HS_TARGET("sse4.1")
+    void transformSse41(const Mat4& M, const float* sx, const float* sy, const float* sz,
+                        float* dx, float* dy, float* dz, size_t begin, size_t n)
+    {
+        const auto& m = M.m;
+        __m128 r[3][4];
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 4; ++j)
+                r[i][j] = _mm_set1_ps(m[i][j]);
+
+        size_t i = begin;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(sx + i);
+            const __m128 y = _mm_loadu_ps(sy + i);
+            const __m128 z = _mm_loadu_ps(sz + i);
+
+            __m128 o[3];
+            for (int k = 0; k < 3; ++k)
+                o[k] = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r[k][0], x), _mm_mul_ps(r[k][1], y)),
+                                             _mm_mul_ps(r[k][2], z)),
+                                  r[k][3]);
+
+            _mm_storeu_ps(dx + i, o[0]);
+            _mm_storeu_ps(dy + i, o[1]);
+            _mm_storeu_ps(dz + i, o[2]);
+        }
+        transformScalar(M, sx, sy, sz, dx, dy, dz, i, n);
+    }
+#endif
+
+#if defined(HS_NEON)
+    void transformNeon(const Mat4& M, const float* sx, const float* sy, const float* sz,
+                       float* dx, float* dy, float* dz, size_t begin, size_t n)
+    {
+        const auto& m = M.m;
+        float32x4_t r[3][4];
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 4; ++j)
+                r[i][j] = vdupq_n_f32(m[i][j]);
+
+        size_t i = begin;
+        for (; i + 4 <= n; i += 4)
+        {
+            const float32x4_t x = vld1q_f32(sx + i);
+            const float32x4_t y = vld1q_f32(sy + i);
+            const float32x4_t z = vld1q_f32(sz + i);
+
+            for (int k = 0; k < 3; ++k)
+            {
+                float32x4_t o = vaddq_f32(vmulq_f32(r[k][0], x), vmulq_f32(r[k][1], y));
+                o = vaddq_f32(o, vmulq_f32(r[k][2], z));
+                o = vaddq_f32(o, r[k][3]);
+                vst1q_f32((k == 0 ? dx : k == 1 ? dy : dz) + i, o);
+            }
+        }
+        transformScalar(M, sx, sy, sz, dx, dy, dz, i, n);
+    }
+#endif
+
+#if defined(HS_NEON)
+    void offsetNeon(const uint32_t* src, uint32_t* dst, size_t begin, size_t n, uint32_t offset)
+    {
+        const uint32x4_t o = vdupq_n_u32(offset);
+        size_t i = begin;
+        for (; i + 4 <= n; i += 4)
+            vst1q_u32(dst + i, vaddq_u32(vld1q_u32(src + i), o));
+        offsetScalar(src, dst, i, n, offset);
+    }
+#endif
+
+    struct Dispatch
+    {
+        TransformFn transform = transformScalar;
+        OffsetFn offset = offsetScalar;
+        const char* isa = "scalar";
+
+        Dispatch()
+        {
+#if defined(HS_X86_DISPATCH)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+            {
+                transform = transformAvx2;
+                offset = offsetAvx2;
+                isa = "avx2";
+            }
+            else if (__builtin_cpu_supports("sse4.1"))
+            {
+                transform = transformSse41;
+                offset = offsetSse41;
+                isa = "sse4.1";
+            }
+#elif defined(HS_NEON)
+            transform = transformNeon;
+            offset = offsetNeon;
+            isa = "neon";
+#endif
+        }
+    };
+
+    const Dispatch& dispatch()
+    {
+        static const Dispatch d;
+        return d;
+    }
+}
+
+void transformPoints(const Mat4& m,
+                     const float* sx, const float* sy, const float* sz,
+                     float* dx, float* dy, float* dz, size_t n)
+{
+    dispatch().transform(m, sx, sy, sz, dx, dy, dz, 0, n);
+}
+
+void offsetIndices(const uint32_t* src, uint32_t* dst, size_t n, uint32_t offset)
+{
+    dispatch().offset(src, dst, 0, n, offset);
+}
+
+const char* pointKernelIsa()
+{
+    return dispatch().isa;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "core/geo/Mat4.h"
+
+// Hot loops over SoA point buffers. Each picks the widest SIMD path the CPU
+// supports at runtime (AVX2 / SSE4.1 on x86-64, NEON on AArch64) and
+// falls back to scalar code elsewhere. Every path gives bit-identical results.
+
+// d = M * s for n points. Source and destination may alias.
+void transformPoints(const Mat4& m,
+                     const float* sx, const float* sy, const float* sz,
+                     float* dx, float* dy, float* dz, size_t n);
+
+// dst[i] = src[i] + offset for n indices (e.g. 3 * triangle count). May alias.
+void offsetIndices(const uint32_t* src, uint32_t* dst, size_t n, uint32_t offset);
+
+// Name of the path the kernels dispatch to ("avx2", "sse4.1", "neon", "scalar").
+const char* pointKernelIsa();
@@ -1,7 +1,24 @@
 #include "core/graph/Graph.h"
 
 #include <algorithm>
+#include <unordered_set>
+#include <utility>
 
+std::vector<std::pair<int, NodeId>>::iterator Connection::find(int input)
+{
+    auto it = std::lower_bound(inputToSrc.begin(), inputToSrc.end(), input,
+                               [](const auto& slot, int i) { return slot.first < i; });
+    return (it != inputToSrc.end() && it->first == input) ? it : inputToSrc.end();
+}
+
+NodeId Connection::set(int input, NodeId src)
+{
+    auto it = std::lower_bound(inputToSrc.begin(), inputToSrc.end(), input,
+                               [](const auto& slot, int i) { return slot.first < i; });
+    if (it != inputToSrc.end() && it->first == input) return std::exchange(it->second, src);
+    inputToSrc.insert(it, {input, src});
+    return 0;
+}
 
 NodeId Graph::addNode(std::unique_ptr<Node> node)
 {
@@ -33,9 +50,42 @@ std::vector<NodeId> Graph::allNodeIds() const
     return ids;
 }
 
+bool Graph::assign(std::vector<std::unique_ptr<Node>> nodes, const std::vector<Wire>& wires)
+{
+    std::unordered_map<NodeId, std::unique_ptr<Node>> byId;
+    byId.reserve(nodes.size());
+    for (auto& n : nodes)
+    {
+        const NodeId id = n->id();
+        if (!byId.emplace(id, std::move(n)).second) return false;
+    }
+
+    std::unordered_map<NodeId, Connection> connections;
+    connections.reserve(wires.size());
+    for (const Wire& w : wires)
+    {
+        if (w.input < 0 || !byId.count(w.src) || !byId.count(w.dst)) return false;
+        connections[w.dst].set(w.input, w.src); // a later wire replaces an earlier one
+    }
+
+    std::unordered_map<NodeId, std::vector<NodeId>> outputs;
+    outputs.reserve(byId.size());
+    for (const auto& [dst, c] : connections)
+        for (const auto& [input, src] : c.inputToSrc)
+            outputs[src].push_back(dst);
+
+    m_nodes = std::move(byId);
+    m_connections = std::move(connections);
+    m_outputs = std::move(outputs);
+    ++m_topologyRev;
+    return true;
+}
+
 void Graph::connect(NodeId src, NodeId dst, int dstInputIndex)
 {
-    m_connections[dst].inputToSrc[dstInputIndex] = src;
+    if (const NodeId previous = m_connections[dst].set(dstInputIndex, src))
+        removeOutput(previous, dst);
+    m_outputs[src].push_back(dst);
     ++m_topologyRev;
 }
 
@@ -43,26 +93,61 @@ void Graph::disconnect(NodeId dst, int dstInputIndex)
 {
     auto it = m_connections.find(dst);
     if (it == m_connections.end()) return;
-    it->second.inputToSrc.erase(dstInputIndex);
+    auto in = it->second.find(dstInputIndex);
+    if (in == it->second.inputToSrc.end()) return;
+    removeOutput(in->second, dst);
+    it->second.inputToSrc.erase(in);
     ++m_topologyRev;
 }
 
-std::vector<NodeId> Graph::inputsOf(NodeId dst) const
+void Graph::removeOutput(NodeId src, NodeId dst)
 {
-    std::vector<std::pair<int, NodeId>> tmp;
-    auto it = m_connections.find(dst);
-    if (it != m_connections.end())
-    {
-        tmp.reserve(it->second.inputToSrc.size());
-        for (auto& kv : it->second.inputToSrc)
-            tmp.push_back({kv.first, kv.second});
-    }
+    auto it = m_outputs.find(src);
+    if (it == m_outputs.end()) return;
 
-    std::sort(tmp.begin(), tmp.end(),
-              [](auto& a, auto& b){ return a.first < b.first; });
+    // one entry per wire, so drop a single occurrence
+    auto& dsts = it->second;
+    auto pos = std::find(dsts.begin(), dsts.end(), dst);
+    if (pos != dsts.end()) dsts.erase(pos);
+    if (dsts.empty()) m_outputs.erase(it);
+}
 
+std::vector<std::pair<int, NodeId>> Graph::inputSlots(NodeId dst) const
+{
+    auto it = m_connections.find(dst);
+    if (it == m_connections.end()) return {};
+    return it->second.inputToSrc; // already sorted
+}
+
+std::vector<NodeId> Graph::inputsOf(NodeId dst) const
+{
+    const auto slots = inputSlots(dst);
     std::vector<NodeId> ordered;
-    ordered.reserve(tmp.size());
-    for (auto& p : tmp) ordered.push_back(p.second);
+    ordered.reserve(slots.size());
+    for (auto& p : slots) ordered.push_back(p.second);
     return ordered;
-}
\ No newline at end of file
+}
+
+std::vector<NodeId> Graph::outputsOf(NodeId src) const
+{
+    auto it = m_outputs.find(src);
+    if (it == m_outputs.end()) return {};
+
+    std::vector<NodeId> out = it->second;
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+std::vector<NodeId> Graph::upstreamOf(NodeId root) const
+{
+    std::vector<NodeId> out;
+    if (!get(root)) return out;
+
+    std::unordered_set<NodeId> seen{root};
+    out.push_back(root);
+    for (size_t i = 0; i < out.size(); ++i)
+        for (NodeId in : inputsOf(out[i]))
+            if (get(in) && seen.insert(in).second) out.push_back(in);
+    return out;
+}
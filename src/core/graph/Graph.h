@@ -8,9 +8,22 @@
 
 struct Connection
 {
-    // input index on dst node -> src node id
-    // (for MVP, we keep it simple: each input index has at most one source)
-    std::unordered_map<int, NodeId> inputToSrc;
+    // (input index on dst node, src node id), sorted by input index; each
+    // input has at most one source. Nodes have a handful of inputs, so a
+    // flat vector beats a map.
+    std::vector<std::pair<int, NodeId>> inputToSrc;
+
+    std::vector<std::pair<int, NodeId>>::iterator find(int input);
+    // Sets input's source; returns the source it replaced (0 = none).
+    NodeId set(int input, NodeId src);
+};
+
+// One connection, for bulk loading: src feeds input `input` of dst.
+struct Wire
+{
+    NodeId src = 0;
+    NodeId dst = 0;
+    int input = 0;
 };
 
 class Graph
@@ -23,11 +36,21 @@ public:
     const Node* get(NodeId id) const;
 
     std::vector<NodeId> allNodeIds() const;
+    size_t nodeCount() const { return m_nodes.size(); }
+
+    // Replaces the whole graph in one step (file loading): containers are
+    // sized once and the topology revision moves once, rather than per
+    // addNode/connect. False, with the graph unchanged, on a duplicate id or
+    // a wire touching an unknown node.
+    bool assign(std::vector<std::unique_ptr<Node>> nodes, const std::vector<Wire>& wires);
 
     void connect(NodeId src, NodeId dst, int dstInputIndex);
     void disconnect(NodeId dst, int dstInputIndex);
 
     std::vector<NodeId> inputsOf(NodeId dst) const; // ordered by input index ascending
+    std::vector<std::pair<int, NodeId>> inputSlots(NodeId dst) const; // (input index, src), ascending
+    std::vector<NodeId> outputsOf(NodeId src) const; // nodes reading src, ascending, no duplicates
+    std::vector<NodeId> upstreamOf(NodeId root) const; // root and every node feeding it, once each
 
     uint64_t topologyRevision() const { return m_topologyRev; }
 
@@ -35,6 +58,9 @@ private:
     NodeId m_nextId = 1;
     std::unordered_map<NodeId, std::unique_ptr<Node>> m_nodes;
     std::unordered_map<NodeId, Connection> m_connections;
+    std::unordered_map<NodeId, std::vector<NodeId>> m_outputs; // reverse index: src -> dsts (one per wire)
+
+    void removeOutput(NodeId src, NodeId dst);
 
     uint64_t m_topologyRev = 1;
 };
\ No newline at end of file
@@ -0,0 +1,414 @@
+#include "core/graph/GraphIO.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/graph/Graph.h"
+#include "core/graph/NodeRegistry.h"
+#include "core/graph/ParamText.h"
+#include "core/io/MappedFile.h"
+
+namespace
+{
+    constexpr std::string_view kHeader = "# hypersphere graph 1";
+
+    std::string_view trim(std::string_view s)
+    {
+        const size_t b = s.find_first_not_of(" \t\r");
+        if (b == std::string_view::npos) return {};
+        const size_t e = s.find_last_not_of(" \t\r");
+        return s.substr(b, e - b + 1);
+    }
+
+    // Splits off the first whitespace-separated word.
+    std::string_view nextWord(std::string_view& s)
+    {
+        s = trim(s);
+        const size_t end = std::min(s.find_first_of(" \t"), s.size());
+        std::string_view w = s.substr(0, end);
+        s = trim(s.substr(end));
+        return w;
+    }
+
+    constexpr char kBinaryMagic[4] = {'H', 'S', 'G', 'B'};
+    constexpr uint32_t kBinaryVersion = 1;
+    constexpr uint32_t kNodeHasUiPos = 1u << 0;
+
+    struct BinHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t nodeCount;
+        uint32_t wireCount;
+        uint32_t typeCount;
+        uint32_t paramCount;
+        uint64_t stringBytes;
+    };
+
+    struct BinString
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct BinNode
+    {
+        uint32_t id;
+        uint32_t type;
+        BinString name;
+        uint32_t flags;
+        float uiX, uiY;
+        uint32_t firstParam;
+        uint32_t paramCount;
+        uint32_t reserved;
+    };
+
+    struct BinParam
+    {
+        BinString name;
+        BinString value;
+    };
+
+    struct BinWire
+    {
+        uint32_t src;
+        uint32_t dst;
+        uint32_t input;
+    };
+
+    static_assert(sizeof(BinHeader) == 32 && sizeof(BinNode) == 40 && sizeof(BinParam) == 16 && sizeof(BinWire) == 12,
+                  "on-disk layout");
+
+    constexpr bool kLittleEndian = std::endian::native == std::endian::little;
+
+    // Builds the string pool, storing each distinct string once.
+    class StringPool
+    {
+    public:
+        BinString add(std::string_view s)
+        {
+            auto it = m_index.find(s);
+            if (it != m_index.end()) return it->second;
+            const BinString ref{uint32_t(m_bytes.size()), uint32_t(s.size())};
+            m_bytes.append(s);
+            m_index.emplace(std::string(s), ref);
+            return ref;
+        }
+
+        const std::string& bytes() const { return m_bytes; }
+
+    private:
+        struct Hash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+        };
+        std::string m_bytes;
+        std::unordered_map<std::string, BinString, Hash, std::equal_to<>> m_index;
+    };
+
+    bool parseId(std::string_view s, NodeId& out)
+    {
+        if (s.empty() || s.size() > 10) return false;
+        uint64_t v = 0;
+        for (char c : s)
+        {
+            if (c < '0' || c > '9') return false;
+            v = v * 10 + uint64_t(c - '0');
+        }
+        if (v == 0 || v > UINT32_MAX) return false;
+        out = NodeId(v);
+        return true;
+    }
+}
+
+bool loadGraphText(std::istream& in, const NodeRegistry& registry, Graph& graph, std::string& error)
+{
+    // Collected first and handed to the graph in one assign().
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<Wire> wires;
+    std::unordered_set<NodeId> ids;
+
+    std::string line;
+    int lineNo = 0;
+    Node* current = nullptr;
+
+    auto fail = [&](const std::string& msg)
+    {
+        error = "line " + std::to_string(lineNo) + ": " + msg;
+        return false;
+    };
+
+    while (std::getline(in, line))
+    {
+        ++lineNo;
+        std::string_view rest = trim(line);
+        if (rest.empty() || rest.front() == '#') continue;
+
+        const std::string_view cmd = nextWord(rest);
+        if (cmd == "node")
+        {
+            NodeId id = 0;
+            if (!parseId(nextWord(rest), id)) return fail("bad node id");
+            const std::string type(nextWord(rest));
+            if (!ids.insert(id).second) return fail("duplicate node id " + std::to_string(id));
+
+            auto node = registry.create(type, id);
+            if (!node) return fail("unknown node type '" + type + "'");
+            if (!rest.empty()) node->setName(std::string(rest));
+            current = node.get();
+            nodes.push_back(std::move(node));
+        }
+        else if (cmd == "param")
+        {
+            if (!current) return fail("param before any node");
+            const std::string_view name = nextWord(rest);
+            if (!current->setParam(name, rest))
+                return fail("bad value for " + std::string(current->typeName()) + "." + std::string(name));
+        }
+        else if (cmd == "pos")
+        {
+            if (!current) return fail("pos before any node");
+            float x = 0, y = 0;
+            if (!paramtext::parseNext(rest, x) || !paramtext::parseNext(rest, y) || !paramtext::atEnd(rest))
+                return fail("bad position");
+            current->setUiPos(x, y);
+        }
+        else if (cmd == "connect")
+        {
+            NodeId src = 0, dst = 0;
+            if (!parseId(nextWord(rest), src) || !parseId(nextWord(rest), dst)) return fail("bad node id");
+            const std::string_view idx = nextWord(rest);
+            int input = 0;
+            for (char c : idx)
+            {
+                if (c < '0' || c > '9' || input > 100000) return fail("bad input index");
+                input = input * 10 + (c - '0');
+            }
+            if (idx.empty()) return fail("missing input index");
+            if (!ids.count(src) || !ids.count(dst)) return fail("connect references an unknown node");
+            wires.push_back({src, dst, input});
+        }
+        else
+        {
+            return fail("unknown directive '" + std::string(cmd) + "'");
+        }
+    }
+
+    // not a line's fault; the checks above should leave nothing for assign to reject
+    if (!graph.assign(std::move(nodes), wires))
+    {
+        error = "duplicate node id or connection to an unknown node";
+        return false;
+    }
+    return true;
+}
+
+bool loadGraphTextFile(const std::string& path, const NodeRegistry& registry, Graph& graph, std::string& error)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    return loadGraphText(in, registry, graph, error);
+}
+
+void saveGraphText(std::ostream& out, const Graph& graph)
+{
+    auto ids = graph.allNodeIds();
+    std::sort(ids.begin(), ids.end());
+
+    out << kHeader << "\n";
+    for (NodeId id : ids)
+    {
+        const Node* n = graph.get(id);
+        out << "node " << id << " " << n->typeName() << " " << n->name() << "\n";
+        for (const auto& [name, value] : n->paramValues())
+            out << "param " << name << " " << value << "\n";
+        if (n->hasUiPos())
+            out << "pos " << paramtext::format(n->uiX()) << " " << paramtext::format(n->uiY()) << "\n";
+    }
+    for (NodeId id : ids)
+        for (const auto& [input, src] : graph.inputSlots(id))
+            out << "connect " << src << " " << id << " " << input << "\n";
+}
+
+bool saveGraphTextFile(const std::string& path, const Graph& graph)
+{
+    std::ofstream out(path);
+    if (!out) return false;
+    saveGraphText(out, graph);
+    return bool(out);
+}
+
+bool loadGraphBinary(const void* data, size_t size, const NodeRegistry& registry, Graph& graph, std::string& error)
+{
+    if (!kLittleEndian)
+    {
+        error = "binary graphs are not supported on big-endian hosts";
+        return false;
+    }
+
+    const auto* base = static_cast<const char*>(data);
+    BinHeader h;
+    if (size < sizeof(h)) { error = "not a binary graph"; return false; }
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, kBinaryMagic, sizeof(kBinaryMagic)) != 0) { error = "not a binary graph"; return false; }
+    if (h.version != kBinaryVersion) { error = "unsupported binary graph version"; return false; }
+
+    const uint64_t typesAt = sizeof(BinHeader);
+    const uint64_t nodesAt = typesAt + uint64_t(h.typeCount) * sizeof(BinString);
+    const uint64_t paramsAt = nodesAt + uint64_t(h.nodeCount) * sizeof(BinNode);
+    const uint64_t wiresAt = paramsAt + uint64_t(h.paramCount) * sizeof(BinParam);
+    const uint64_t stringsAt = wiresAt + uint64_t(h.wireCount) * sizeof(BinWire);
+    if (stringsAt > size || h.stringBytes != size - stringsAt) { error = "truncated binary graph"; return false; }
+
+    const char* strings = base + stringsAt;
+    bool badString = false;
+    auto str = [&](const BinString& r) -> std::string_view
+    {
+        if (uint64_t(r.offset) + r.length > h.stringBytes) { badString = true; return {}; }
+        return {strings + r.offset, r.length};
+    };
+
+    // tables are read with memcpy: the file is only byte-aligned in general
+    auto read = [base](uint64_t at, auto& rec) { std::memcpy(&rec, base + at, sizeof(rec)); };
+
+    std::vector<const NodeRegistry::Factory*> factories(h.typeCount);
+    std::vector<std::string_view> typeNames(h.typeCount);
+    for (uint32_t t = 0; t < h.typeCount; ++t)
+    {
+        BinString r;
+        read(typesAt + t * sizeof(BinString), r);
+        typeNames[t] = str(r);
+        factories[t] = registry.find(std::string(typeNames[t]));
+        if (!factories[t]) { error = "unknown node type '" + std::string(typeNames[t]) + "'"; return false; }
+    }
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    nodes.reserve(h.nodeCount);
+    for (uint32_t i = 0; i < h.nodeCount; ++i)
+    {
+        BinNode r;
+        read(nodesAt + uint64_t(i) * sizeof(BinNode), r);
+        if (r.id == 0 || r.type >= h.typeCount) { error = "bad node record " + std::to_string(i); return false; }
+        if (uint64_t(r.firstParam) + r.paramCount > h.paramCount) { error = "bad node record " + std::to_string(i); return false; }
+
+        auto node = (*factories[r.type])(r.id);
+        node->setName(std::string(str(r.name)));
+        if (r.flags & kNodeHasUiPos) node->setUiPos(r.uiX, r.uiY);
+
+        for (uint32_t k = 0; k < r.paramCount; ++k)
+        {
+            BinParam p;
+            read(paramsAt + uint64_t(r.firstParam + k) * sizeof(BinParam), p);
+            const std::string_view name = str(p.name);
+            if (!node->setParam(name, str(p.value)) && !badString)
+            {
+                error = "node " + std::to_string(r.id) + ": bad value for " + std::string(typeNames[r.type]) + "." + std::string(name);
+                return false;
+            }
+        }
+        nodes.push_back(std::move(node));
+    }
+    if (badString) { error = "string out of range"; return false; }
+
+    std::vector<Wire> wires(h.wireCount);
+    for (uint32_t i = 0; i < h.wireCount; ++i)
+    {
+        BinWire r;
+        read(wiresAt + uint64_t(i) * sizeof(BinWire), r);
+        if (r.input > 100000) { error = "bad input index"; return false; }
+        wires[i] = {r.src, r.dst, int(r.input)};
+    }
+
+    if (!graph.assign(std::move(nodes), wires))
+    {
+        error = "duplicate node id or connection to an unknown node";
+        return false;
+    }
+    return true;
+}
+
+void saveGraphBinary(std::ostream& out, const Graph& graph)
+{
+    const auto ids = graph.allNodeIds();
+
+    StringPool pool;
+    std::vector<BinString> types;
+    std::unordered_map<std::string_view, uint32_t> typeIndex;
+    std::vector<BinNode> nodes;
+    std::vector<BinParam> params;
+    std::vector<BinWire> wires;
+    nodes.reserve(ids.size());
+
+    for (NodeId id : ids)
+    {
+        const Node* n = graph.get(id);
+        const std::string_view type = n->typeName();
+        auto [t, added] = typeIndex.emplace(type, uint32_t(types.size()));
+        if (added) types.push_back(pool.add(type));
+
+        BinNode r{};
+        r.id = id;
+        r.type = t->second;
+        r.name = pool.add(n->name());
+        r.flags = n->hasUiPos() ? kNodeHasUiPos : 0;
+        r.uiX = n->uiX();
+        r.uiY = n->uiY();
+        r.firstParam = uint32_t(params.size());
+        for (const auto& [name, value] : n->paramValues())
+            params.push_back({pool.add(name), pool.add(value)});
+        r.paramCount = uint32_t(params.size()) - r.firstParam;
+        nodes.push_back(r);
+
+        for (const auto& [input, src] : graph.inputSlots(id))
+            wires.push_back({src, id, uint32_t(input)});
+    }
+
+    BinHeader h{};
+    std::memcpy(h.magic, kBinaryMagic, sizeof(kBinaryMagic));
+    h.version = kBinaryVersion;
+    h.nodeCount = uint32_t(nodes.size());
+    h.wireCount = uint32_t(wires.size());
+    h.typeCount = uint32_t(types.size());
+    h.paramCount = uint32_t(params.size());
+    h.stringBytes = pool.bytes().size();
+
+    auto put = [&out](const void* p, size_t n) { out.write(static_cast<const char*>(p), std::streamsize(n)); };
+    put(&h, sizeof(h));
+    put(types.data(), types.size() * sizeof(BinString));
+    put(nodes.data(), nodes.size() * sizeof(BinNode));
+    put(params.data(), params.size() * sizeof(BinParam));
+    put(wires.data(), wires.size() * sizeof(BinWire));
+    put(pool.bytes().data(), pool.bytes().size());
+}
+
+bool loadGraphFile(const std::string& path, const NodeRegistry& registry, Graph& graph, std::string& error)
+{
+    auto file = MappedFile::open(path, error);
+    if (!file) return false;
+
+    if (file->size() >= sizeof(kBinaryMagic) && std::memcmp(file->data(), kBinaryMagic, sizeof(kBinaryMagic)) == 0)
+        return loadGraphBinary(file->data(), file->size(), registry, graph, error);
+    return loadGraphTextFile(path, registry, graph, error);
+}
+
+bool saveGraphFile(const std::string& path, const Graph& graph)
+{
+    const bool binary = path.size() >= 5 && path.compare(path.size() - 5, 5, ".hsgb") == 0;
+    std::ofstream out(path, binary ? std::ios::binary : std::ios::out);
+    if (!out) return false;
+    if (binary) saveGraphBinary(out, graph);
+    else saveGraphText(out, graph);
+    return bool(out);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+class Graph;
+class NodeRegistry;
+
+// Line-based text graph files:
+//
+//   # hypersphere graph 1
+//   node 1 Grid grid1
+//   param rows 200
+//   node 2 Transform xform2
+//   param translate 0 1 0
+//   pos 0 140                (node editor position, optional)
+//   connect 1 2 0            (src dst input)
+//
+// "param" lines apply to the node above them. Blank lines and # comments are
+// ignored.
+
+// Loaders replace the graph's contents in one Graph::assign. On failure they
+// return false with a message (text: including the line number) in error,
+// and the graph is left as it was.
+bool loadGraphText(std::istream& in, const NodeRegistry& registry, Graph& graph, std::string& error);
+bool loadGraphTextFile(const std::string& path, const NodeRegistry& registry, Graph& graph, std::string& error);
+
+void saveGraphText(std::ostream& out, const Graph& graph);
+bool saveGraphTextFile(const std::string& path, const Graph& graph);
+
+// Binary graph files (.hsgb): the same content as the text form in
+// fixed-size little-endian tables plus one string pool, so loading is a
+// single pass into presized containers:
+//
+//   header   "HSGB", version, node/wire/type/param counts, string pool size
+//   types    one (offset, length) per distinct node type
+//   nodes    id, type index, name, flags, editor position, param range
+//   params   name and text value, as (offset, length) pairs
+//   wires    src, dst, input index
+//   strings  every distinct string once, no terminators
+bool loadGraphBinary(const void* data, size_t size, const NodeRegistry& registry, Graph& graph, std::string& error);
+void saveGraphBinary(std::ostream& out, const Graph& graph);
+
+// Either format: loading sniffs the content, saving picks binary for a
+// .hsgb extension and text otherwise.
+bool loadGraphFile(const std::string& path, const NodeRegistry& registry, Graph& graph, std::string& error);
+bool saveGraphFile(const std::string& path, const Graph& graph);
@@ -1 +1,32 @@
-#include "core/graph/Node.h"
\ No newline at end of file
+#include "core/graph/Node.h"
+
+#include "core/util/Hash.h"
+#include "core/util/ThreadPool.h"
+
+void CookContext::parallelFor(size_t n, size_t grain,
+                              const std::function<void(size_t, size_t)>& fn) const
+{
+    if (pool) pool->parallelFor(n, grain, fn);
+    else if (n > 0) fn(0, n);
+}
+
+void Node::hashParams(Hasher& h) const
+{
+    m_params.hash(h);
+}
+
+Node::ParamList Node::paramValues() const
+{
+    const ParamLayout& layout = m_params.layout();
+    ParamList out;
+    out.reserve(layout.size());
+    for (size_t i = 0; i < layout.size(); ++i)
+        out.emplace_back(layout[i].name, m_params.text(i));
+    return out;
+}
+
+bool Node::setParam(std::string_view name, std::string_view value)
+{
+    const int i = m_params.layout().indexOf(name);
+    return i >= 0 && m_params.setText(size_t(i), value);
+}
@@ -1,22 +1,61 @@
 #pragma once
+#include <atomic>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <cstdint>
 
 #include "core/geo/Geometry.h"
+#include "core/graph/Params.h"
 
 using NodeId = uint32_t;
 
+class Hasher;
+class ThreadPool;
+
+// Set from any thread to ask a cook to stop early.
+class CancelToken
+{
+public:
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> m_cancelled{false};
+};
+
+// Passed to every cook. Long-running SOPs should poll cancelled() in their
+// outer loops and return early (the cooker discards whatever they return),
+// and may report how far along they are.
 struct CookContext
 {
-    // later: time, frame, random seed, cancellation, etc.
+    const CancelToken* cancel = nullptr;  // null = cannot be cancelled
+    std::function<void(float)> progress;  // optional; fraction in [0, 1], called from cook threads
+    ThreadPool* pool = nullptr;           // for data-parallel SOP loops; null = serial
+    bool preview = false;                 // interactive edit in flight: see Node::hasPreview()
+    int frame = 1;                        // timeline frame being cooked (see Node::isTimeDependent())
+    double fps = 24.0;
+
+    // Seconds since frame 1.
+    double time() const { return double(frame - 1) / fps; }
+
+    bool cancelled() const { return cancel && cancel->cancelled(); }
+    void reportProgress(float fraction) const { if (progress) progress(fraction); }
+
+    // fn(begin, end) over [0, n) in chunks of `grain`, on the pool if there is one.
+    void parallelFor(size_t n, size_t grain, const std::function<void(size_t, size_t)>& fn) const;
+
+    // later: random seed, etc.
 };
 
 class Node
 {
 public:
-    explicit Node(NodeId id) : m_id(id) {}
+    explicit Node(NodeId id, const ParamLayout& layout = ParamLayout::empty())
+        : m_id(id), m_params(layout) {}
     virtual ~Node() = default;
 
     NodeId id() const { return m_id; }
@@ -25,6 +64,13 @@ public:
     const std::string& name() const { return m_name; }
     void setName(std::string n) { m_name = std::move(n); }
 
+    // Where the node editor shows the node; saved with the graph. Unset until
+    // the editor (or a loaded file) places it.
+    bool hasUiPos() const { return m_hasUiPos; }
+    float uiX() const { return m_uiX; }
+    float uiY() const { return m_uiY; }
+    void setUiPos(float x, float y) { m_uiX = x; m_uiY = y; m_hasUiPos = true; }
+
     // type name for factory/registry
     virtual const char* typeName() const = 0;
 
@@ -32,14 +78,46 @@ public:
     virtual Geometry cook(const CookContext& ctx,
                           const std::vector<std::shared_ptr<const Geometry>>& inputs) const = 0;
 
-    // Parameters revision: bump when user edits params
-    uint64_t paramRevision() const { return m_paramRev; }
-    void bumpParamRevision() { ++m_paramRev; }
+    // The node's parameters, laid out by its type's ParamLayout. Writes must
+    // not race a cook (the editor interrupts the cooker first); the cooker
+    // notices edits by comparing content, so nothing else needs to be told.
+    const ParamSet& params() const { return m_params; }
+    ParamSet& params() { return m_params; }
+
+    // Feed everything that affects cook() into h. Two nodes of the same type
+    // with equal parameter hashes and equal inputs must cook identical geometry.
+    // Default is the parameter block; override to add state from outside it.
+    virtual void hashParams(Hasher& h) const;
+
+    // Parameters as (name, text value) pairs, for saving graphs. setParam
+    // parses the same text back; false for an unknown name or bad value.
+    using ParamList = std::vector<std::pair<std::string, std::string>>;
+    ParamList paramValues() const;
+    bool setParam(std::string_view name, std::string_view value);
+
+    // True if, with the current parameters, cook() gives a cheaper coarse
+    // result when ctx.preview is set (e.g. a big grid cooks fewer rows). The
+    // cooker keys those results apart from full-resolution ones.
+    virtual bool hasPreview() const { return false; }
+
+    // True if, with the current parameters, cook() reads ctx.frame or
+    // ctx.time(). Only these nodes are keyed by time: their results are kept
+    // per frame, and everything upstream of them is cooked once and shared by
+    // every frame.
+    virtual bool isTimeDependent() const { return false; }
+
+    // Why cook() gave up with the current parameters (it still returns some
+    // geometry, usually empty); empty if it didn't. The editor shows it and
+    // the batch tool fails on it. Safe to call while cooks run.
+    virtual std::string cookError() const { return {}; }
 
-    // Graph topology revision bump happens in Graph; nodes track only params here.
+    // How many inputs the node reads; -1 means any number (Merge).
+    virtual int maxInputs() const { return 1; }
 
 private:
     NodeId m_id;
     std::string m_name;
-    uint64_t m_paramRev = 1;
+    float m_uiX = 0.0f, m_uiY = 0.0f;
+    bool m_hasUiPos = false;
+    ParamSet m_params;
 };
\ No newline at end of file
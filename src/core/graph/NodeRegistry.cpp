@@ -20,4 +20,9 @@ std::unique_ptr<Node> NodeRegistry::create(const std::string& typeName, NodeId i
     auto it = m_factories.find(typeName);
     if (it == m_factories.end()) return {};
     return it->second(id);
-}
\ No newline at end of file
+}
+const NodeRegistry::Factory* NodeRegistry::find(const std::string& typeName) const
+{
+    auto it = m_factories.find(typeName);
+    return it == m_factories.end() ? nullptr : &it->second;
+}
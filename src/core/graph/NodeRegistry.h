@@ -15,6 +15,8 @@ public:
     void registerType(std::string typeName, Factory f);
     std::vector<std::string> types() const;
     std::unique_ptr<Node> create(const std::string& typeName, NodeId id) const;
+    // Null if unknown; lets loaders look a type up once rather than per node.
+    const Factory* find(const std::string& typeName) const;
 
 private:
     std::unordered_map<std::string, Factory> m_factories;
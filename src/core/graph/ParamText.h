@@ -0,0 +1,63 @@
+#pragma once
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "core/geo/Geometry.h"
+
+// Text form of parameter values, as used by graph files: ints and floats as
+// plain numbers, vectors as "x y z". Floats round-trip exactly.
+namespace paramtext
+{
+    inline std::string format(int v) { return std::to_string(v); }
+
+    inline std::string format(float v)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.9g", double(v));
+        return buf;
+    }
+
+    inline std::string format(const Vec3& v)
+    {
+        return format(v.x) + " " + format(v.y) + " " + format(v.z);
+    }
+
+    // Parsers consume from the front of s and fail on anything left over.
+    // from_chars: no allocation, and immune to the process locale (Qt sets it).
+    template <class T> bool parseNext(std::string_view& s, T& out)
+    {
+        const size_t b = s.find_first_not_of(" \t\r");
+        if (b == std::string_view::npos) return false;
+        s.remove_prefix(b);
+        if (s.front() == '+') s.remove_prefix(1);
+
+        const auto r = std::from_chars(s.data(), s.data() + s.size(), out);
+        if (r.ec != std::errc()) return false;
+        s.remove_prefix(size_t(r.ptr - s.data()));
+        return true;
+    }
+
+    inline bool atEnd(std::string_view s)
+    {
+        return s.find_first_not_of(" \t\r") == std::string_view::npos;
+    }
+
+    template <class T> bool parse(std::string_view s, T& out)
+    {
+        T v{};
+        if (!parseNext(s, v) || !atEnd(s)) return false;
+        out = v;
+        return true;
+    }
+
+    inline bool parse(std::string_view s, Vec3& out)
+    {
+        Vec3 v;
+        if (!parseNext(s, v.x) || !parseNext(s, v.y) || !parseNext(s, v.z) || !atEnd(s)) return false;
+        out = v;
+        return true;
+    }
+}
@@ -0,0 +1,217 @@
+#include "core/graph/Params.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#include "core/graph/ParamText.h"
+#include "core/util/Hash.h"
+
+namespace
+{
+    uint32_t wordsFor(ParamType t)
+    {
+        return t == ParamType::Vec3 ? 3 : 1;
+    }
+}
+
+ParamLayout::ParamLayout(std::initializer_list<ParamDesc> params)
+    : m_params(params)
+{
+    m_offsets.reserve(m_params.size());
+    for (const ParamDesc& d : m_params)
+    {
+        m_offsets.push_back(m_words);
+        m_words += wordsFor(d.type);
+    }
+}
+
+int ParamLayout::indexOf(std::string_view name) const
+{
+    for (size_t i = 0; i < m_params.size(); ++i)
+        if (name == m_params[i].name) return int(i);
+    return -1;
+}
+
+const ParamLayout& ParamLayout::empty()
+{
+    static const ParamLayout layout({});
+    return layout;
+}
+
+ParamSet::ParamSet(const ParamLayout& layout)
+    : m_layout(&layout)
+    , m_words(layout.words(), 0)
+{
+    resetToDefaults();
+}
+
+void ParamSet::resetToDefaults()
+{
+    m_strings.clear();
+    for (size_t i = 0; i < m_layout->size(); ++i)
+    {
+        const ParamDesc& d = (*m_layout)[i];
+        switch (d.type)
+        {
+            case ParamType::Int:
+            case ParamType::Menu: setInt(i, int(d.def[0])); break;
+            case ParamType::Float: setFloat(i, d.def[0]); break;
+            case ParamType::Vec3: setVec3(i, {d.def[0], d.def[1], d.def[2]}); break;
+            case ParamType::String:
+                m_words[m_layout->offset(i)] = uint32_t(m_strings.size());
+                m_strings.emplace_back(d.defText);
+                break;
+        }
+    }
+}
+
+float ParamSet::clamp(size_t i, float v) const
+{
+    const ParamDesc& d = (*m_layout)[i];
+    if (std::isnan(v)) return d.def[0];
+    return std::clamp(v, d.min, d.max);
+}
+
+void ParamSet::putFloat(uint32_t word, float v)
+{
+    if (v == 0.0f) v = 0.0f; // one bit pattern per value, so the block hashes by content
+    std::memcpy(&m_words[word], &v, sizeof(v));
+}
+
+float ParamSet::readFloat(uint32_t word) const
+{
+    float v;
+    std::memcpy(&v, &m_words[word], sizeof(v));
+    return v;
+}
+
+int ParamSet::getInt(size_t i) const
+{
+    return int32_t(m_words[m_layout->offset(i)]);
+}
+
+float ParamSet::getFloat(size_t i) const
+{
+    return readFloat(m_layout->offset(i));
+}
+
+Vec3 ParamSet::getVec3(size_t i) const
+{
+    const uint32_t w = m_layout->offset(i);
+    return {readFloat(w), readFloat(w + 1), readFloat(w + 2)};
+}
+
+const std::string& ParamSet::getString(size_t i) const
+{
+    return m_strings[m_words[m_layout->offset(i)]];
+}
+
+void ParamSet::setInt(size_t i, int v)
+{
+    const ParamDesc& d = (*m_layout)[i];
+    if (d.type == ParamType::Menu)
+        v = std::clamp(v, 0, std::max(0, int(d.items.size()) - 1));
+    else
+        v = std::clamp(v, int(d.min), int(d.max));
+    m_words[m_layout->offset(i)] = uint32_t(int32_t(v));
+}
+
+void ParamSet::setFloat(size_t i, float v)
+{
+    putFloat(m_layout->offset(i), clamp(i, v));
+}
+
+void ParamSet::setVec3(size_t i, const Vec3& v)
+{
+    const uint32_t w = m_layout->offset(i);
+    putFloat(w, clamp(i, v.x));
+    putFloat(w + 1, clamp(i, v.y));
+    putFloat(w + 2, clamp(i, v.z));
+}
+
+void ParamSet::setString(size_t i, std::string v)
+{
+    m_strings[m_words[m_layout->offset(i)]] = std::move(v);
+}
+
+std::string ParamSet::text(size_t i) const
+{
+    switch ((*m_layout)[i].type)
+    {
+        case ParamType::Int:
+        case ParamType::Menu: return paramtext::format(getInt(i));
+        case ParamType::Float: return paramtext::format(getFloat(i));
+        case ParamType::Vec3: return paramtext::format(getVec3(i));
+        case ParamType::String: return getString(i);
+    }
+    return {};
+}
+
+bool ParamSet::setText(size_t i, std::string_view value)
+{
+    const ParamDesc& d = (*m_layout)[i];
+    switch (d.type)
+    {
+        case ParamType::Int:
+        {
+            int v = 0;
+            if (!paramtext::parse(value, v)) return false;
+            setInt(i, v);
+            return true;
+        }
+        case ParamType::Menu:
+        {
+            int v = 0;
+            if (!paramtext::parse(value, v) || v < 0 || size_t(v) >= d.items.size()) return false;
+            setInt(i, v);
+            return true;
+        }
+        case ParamType::Float:
+        {
+            float v = 0.0f;
+            if (!paramtext::parse(value, v)) return false;
+            setFloat(i, v);
+            return true;
+        }
+        case ParamType::Vec3:
+        {
+            Vec3 v;
+            if (!paramtext::parse(value, v)) return false;
+            setVec3(i, v);
+            return true;
+        }
+        case ParamType::String:
+            setString(i, std::string(value));
+            return true;
+    }
+    return false;
+}
+
+void ParamSet::hash(Hasher& h) const
+{
+    // Hasher works on little-endian bytes; the block already is one on most targets.
+    if constexpr (std::endian::native == std::endian::little)
+        h.addBytes(m_words.data(), m_words.size() * sizeof(uint32_t));
+    else
+        for (uint32_t w : m_words)
+        {
+            const unsigned char b[4] = {(unsigned char)w, (unsigned char)(w >> 8),
+                                        (unsigned char)(w >> 16), (unsigned char)(w >> 24)};
+            h.addBytes(b, sizeof(b));
+        }
+    for (const std::string& s : m_strings) h.add(std::string_view(s));
+}
+
+uint64_t ParamSet::hash() const
+{
+    Hasher h;
+    hash(h);
+    return h.value();
+}
+
+bool ParamSet::operator==(const ParamSet& o) const
+{
+    return m_layout == o.m_layout && m_words == o.m_words && m_strings == o.m_strings;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/geo/Geometry.h"
+
+class Hasher;
+
+enum class ParamType : uint8_t
+{
+    Int,
+    Float,
+    Vec3,
+    Menu,    // int index into ParamDesc::items
+    String
+};
+
+// One parameter of a node type. Ranges are hard limits: setters clamp to
+// them, and the editor uses them for its widgets.
+struct ParamDesc
+{
+    const char* name;                  // saved in graph files; never rename
+    const char* label;                 // shown in the editor
+    ParamType type;
+    float def[3] = {0, 0, 0};          // Int/Menu use def[0]
+    float min = 0.0f;
+    float max = 0.0f;
+    std::vector<const char*> items;    // Menu entries
+    const char* fileFilter = nullptr;  // String: a file path, browsed with this dialog filter
+    const char* defText = "";          // String default
+};
+
+// The parameters of one node type, in display order. Built once per type (a
+// static in the SOP's .cpp) and shared by every instance.
+class ParamLayout
+{
+public:
+    ParamLayout(std::initializer_list<ParamDesc> params);
+
+    size_t size() const { return m_params.size(); }
+    const ParamDesc& operator[](size_t i) const { return m_params[i]; }
+    auto begin() const { return m_params.begin(); }
+    auto end() const { return m_params.end(); }
+
+    // -1 if there's no such parameter.
+    int indexOf(std::string_view name) const;
+
+    // Word offset of parameter i in ParamSet storage.
+    uint32_t offset(size_t i) const { return m_offsets[i]; }
+    uint32_t words() const { return m_words; }
+
+    // Shared by node types without parameters.
+    static const ParamLayout& empty();
+
+private:
+    std::vector<ParamDesc> m_params;
+    std::vector<uint32_t> m_offsets;
+    uint32_t m_words = 0;
+};
+
+// Values of one node's parameters: every numeric value packed into one
+// contiguous block of 32-bit words (a Vec3 is three), strings alongside.
+// Hashing and comparing a node's parameters is one pass over the block.
+class ParamSet
+{
+public:
+    explicit ParamSet(const ParamLayout& layout);
+
+    const ParamLayout& layout() const { return *m_layout; }
+
+    int getInt(size_t i) const;      // Int and Menu
+    float getFloat(size_t i) const;
+    Vec3 getVec3(size_t i) const;
+    const std::string& getString(size_t i) const;
+
+    void setInt(size_t i, int v);    // Int and Menu
+    void setFloat(size_t i, float v);
+    void setVec3(size_t i, const Vec3& v);
+    void setString(size_t i, std::string v);
+
+    // Text form as used by graph files (see ParamText.h); menus save their
+    // index. setText is false for a malformed value or a menu index out of range.
+    std::string text(size_t i) const;
+    bool setText(size_t i, std::string_view value);
+
+    void resetToDefaults();
+
+    void hash(Hasher& h) const;
+    uint64_t hash() const;
+
+    bool operator==(const ParamSet& o) const;
+    bool operator!=(const ParamSet& o) const { return !(*this == o); }
+
+private:
+    const ParamLayout* m_layout;
+    std::vector<uint32_t> m_words;
+    std::vector<std::string> m_strings; // String params; their word holds the index here
+
+    float clamp(size_t i, float v) const;
+    void putFloat(uint32_t word, float v);
+    float readFloat(uint32_t word) const;
+};
@@ -0,0 +1,327 @@
+#include "core/io/GeoFile.h"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/geo/Geometry.h"
+#include "core/io/MappedFile.h"
+
+namespace
+{
+    constexpr char kMagic[4] = {'H', 'G', 'E', 'O'};
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kFlagChecksums = 1u << 0;
+    constexpr uint64_t kSectionAlignment = 64;
+
+    enum ChunkKind : uint8_t
+    {
+        kChunkAttribute = 0,
+        kChunkTriangles = 1
+    };
+
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t flags;
+        uint32_t chunkCount;
+        uint64_t numPoints;
+        uint64_t numPrims;
+        uint64_t chunkTableOffset;
+        uint64_t fileSize;
+        uint64_t reserved[2];
+    };
+
+    struct ChunkEntry
+    {
+        uint8_t kind;
+        uint8_t attribClass;
+        uint8_t type;
+        uint8_t tupleSize;
+        uint32_t component;
+        uint64_t offset;
+        uint64_t count;
+        uint64_t checksum;
+        char name[32];
+    };
+
+    static_assert(sizeof(FileHeader) == 64 && sizeof(ChunkEntry) == 64, "on-disk layout");
+    static_assert(sizeof(Tri) == 12 && sizeof(float) == 4 && sizeof(int32_t) == 4, "on-disk element sizes");
+
+    constexpr bool kLittleEndian = std::endian::native == std::endian::little;
+
+    uint64_t alignUp(uint64_t v) { return (v + kSectionAlignment - 1) & ~(kSectionAlignment - 1); }
+
+    // Word-at-a-time checksum (four independent multiply-xor lanes), a few
+    // GB/s: it only has to catch truncation and bit rot, not adversaries.
+    uint64_t checksum(const void* data, size_t n)
+    {
+        const auto* p = static_cast<const unsigned char*>(data);
+        uint64_t lane[4] = {0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull, 0x27d4eb2f165667c5ull};
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                uint64_t w;
+                std::memcpy(&w, p + i + 8 * k, 8);
+                lane[k] = (lane[k] ^ w) * 0x100000001b3ull;
+                lane[k] ^= lane[k] >> 29;
+            }
+        }
+        uint64_t h = lane[0] ^ (lane[1] << 1) ^ (lane[2] << 2) ^ (lane[3] << 3) ^ uint64_t(n);
+        for (; i < n; ++i) h = (h ^ p[i]) * 0x100000001b3ull;
+        h ^= h >> 31;
+        h *= 0xbf58476d1ce4e5b9ull;
+        return h ^ (h >> 29);
+    }
+
+    size_t elementSize(const ChunkEntry& e) { return e.kind == kChunkTriangles ? sizeof(Tri) : 4; }
+
+    // Unique per process and call, so writers sharing a directory don't collide.
+    std::string tempPathFor(const std::string& path)
+    {
+        static const uint64_t salt = (uint64_t(std::random_device{}()) << 32)
+                                   ^ uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+        static std::atomic<uint64_t> counter{0};
+        char suffix[40];
+        std::snprintf(suffix, sizeof(suffix), ".%016llx.tmp",
+                      (unsigned long long)(salt + counter.fetch_add(1, std::memory_order_relaxed)));
+        return path + suffix;
+    }
+
+    struct PendingChunk
+    {
+        ChunkEntry entry;
+        const void* data;
+    };
+}
+
+bool writeGeo(const Geometry& geo, const std::string& path, std::string& error, const GeoWriteOptions& options)
+{
+    if (!kLittleEndian)
+    {
+        error = "writing .hgeo on big-endian hosts is not supported";
+        return false;
+    }
+
+    std::vector<PendingChunk> chunks;
+    for (AttribClass c : {AttribClass::Point, AttribClass::Prim, AttribClass::Vertex, AttribClass::Detail})
+    {
+        for (const Attribute& a : geo.table(c).attributes())
+        {
+            if (a.name().size() >= sizeof(ChunkEntry::name))
+            {
+                error = "attribute name too long for .hgeo: " + a.name();
+                return false;
+            }
+            for (int k = 0; k < a.tupleSize(); ++k)
+            {
+                ChunkEntry e{};
+                e.kind = kChunkAttribute;
+                e.attribClass = uint8_t(c);
+                e.type = uint8_t(a.type());
+                e.tupleSize = uint8_t(a.tupleSize());
+                e.component = uint32_t(k);
+                e.count = a.size();
+                std::memcpy(e.name, a.name().data(), a.name().size());
+                const void* data = a.type() == AttribType::Float ? static_cast<const void*>(a.floats(k))
+                                                                 : static_cast<const void*>(a.ints(k));
+                chunks.push_back({e, data});
+            }
+        }
+    }
+    {
+        ChunkEntry e{};
+        e.kind = kChunkTriangles;
+        e.count = geo.numPrims();
+        chunks.push_back({e, geo.Tris.data()});
+    }
+
+    FileHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.flags = options.checksums ? kFlagChecksums : 0;
+    h.chunkCount = uint32_t(chunks.size());
+    h.numPoints = geo.numPoints();
+    h.numPrims = geo.numPrims();
+    h.chunkTableOffset = sizeof(FileHeader);
+
+    uint64_t offset = alignUp(sizeof(FileHeader) + chunks.size() * sizeof(ChunkEntry));
+    for (auto& c : chunks)
+    {
+        c.entry.offset = offset;
+        const size_t bytes = size_t(c.entry.count) * elementSize(c.entry);
+        if (options.checksums && bytes) c.entry.checksum = checksum(c.data, bytes);
+        offset = alignUp(offset + bytes);
+    }
+    h.fileSize = offset;
+
+    const std::string tmp = tempPathFor(path);
+    std::unique_ptr<FILE, int(*)(FILE*)> f(std::fopen(tmp.c_str(), "wb"), &std::fclose);
+    if (!f)
+    {
+        error = "cannot write " + tmp;
+        return false;
+    }
+
+    static const char zeros[kSectionAlignment] = {};
+    uint64_t written = 0;
+    auto put = [&](const void* p, size_t n)
+    {
+        if (n && std::fwrite(p, 1, n, f.get()) != n) return false;
+        written += n;
+        return true;
+    };
+    auto padTo = [&](uint64_t target) { return put(zeros, size_t(target - written)); };
+
+    bool ok = put(&h, sizeof(h));
+    for (const auto& c : chunks) ok = ok && put(&c.entry, sizeof(ChunkEntry));
+    for (const auto& c : chunks)
+    {
+        ok = ok && padTo(c.entry.offset);
+        ok = ok && put(c.data, size_t(c.entry.count) * elementSize(c.entry));
+    }
+    ok = ok && padTo(h.fileSize);
+    ok = ok && std::fflush(f.get()) == 0;
+    f.reset();
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmp, path, ec);
+    if (!ok || ec)
+    {
+        std::filesystem::remove(tmp, ec);
+        error = "failed writing " + path;
+        return false;
+    }
+    return true;
+}
+
+bool readGeo(const std::string& path, Geometry& out, std::string& error, const GeoReadOptions& options)
+{
+    if (!kLittleEndian)
+    {
+        error = "reading .hgeo on big-endian hosts is not supported";
+        return false;
+    }
+
+    auto file = MappedFile::open(path, error);
+    if (!file) return false;
+
+    auto fail = [&](const char* msg)
+    {
+        error = path + ": " + msg;
+        return false;
+    };
+
+    const std::byte* base = file->data();
+    const uint64_t size = file->size();
+    if (size < sizeof(FileHeader)) return fail("not an .hgeo file");
+
+    FileHeader h;
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) return fail("not an .hgeo file");
+    if (h.version != kVersion) return fail("unsupported .hgeo version");
+    if (h.fileSize != size) return fail("truncated file");
+    if (h.numPrims > UINT32_MAX || h.numPoints > UINT32_MAX) return fail("bad element counts");
+    if (h.chunkTableOffset < sizeof(FileHeader) || h.chunkCount > (size - h.chunkTableOffset) / sizeof(ChunkEntry))
+        return fail("bad chunk table");
+
+    std::vector<ChunkEntry> entries(h.chunkCount);
+    std::memcpy(entries.data(), base + h.chunkTableOffset, entries.size() * sizeof(ChunkEntry));
+
+    // The mapping is owned by every buffer that points into it.
+    const std::shared_ptr<const void> owner = file;
+
+    Geometry g;
+    AttribTable tables[4];
+    bool haveTris = false;
+
+    // attribute components arrive one chunk each; group them back up
+    struct Pending { const ChunkEntry* first; std::vector<const ChunkEntry*> comps; };
+    std::map<std::pair<int, std::string>, Pending> attribs;
+
+    for (const ChunkEntry& e : entries)
+    {
+        const uint64_t bytes = e.count * elementSize(e);
+        if (e.offset % kSectionAlignment || e.offset > size || bytes > size - e.offset)
+            return fail("chunk out of bounds");
+        if (options.verify && (h.flags & kFlagChecksums) && checksum(base + e.offset, size_t(bytes)) != e.checksum)
+            return fail("checksum mismatch");
+
+        if (e.kind == kChunkTriangles)
+        {
+            if (e.count != h.numPrims) return fail("bad triangle count");
+            const auto* tris = reinterpret_cast<const Tri*>(base + e.offset);
+            if (options.verify)
+                for (size_t i = 0; i < e.count; ++i)
+                    if (tris[i].a >= h.numPoints || tris[i].b >= h.numPoints || tris[i].c >= h.numPoints)
+                        return fail("triangle index out of range");
+            g.Tris = CowArray<Tri>::external(tris, size_t(e.count), owner);
+            haveTris = true;
+            continue;
+        }
+
+        if (e.kind != kChunkAttribute || e.attribClass > uint8_t(AttribClass::Detail) ||
+            e.type > uint8_t(AttribType::Int) || e.tupleSize == 0 || e.component >= e.tupleSize ||
+            e.name[sizeof(e.name) - 1] != '\0')
+            return fail("bad chunk entry");
+
+        const uint64_t expected = e.attribClass == uint8_t(AttribClass::Point) ? h.numPoints
+                                : e.attribClass == uint8_t(AttribClass::Prim) ? h.numPrims
+                                : e.attribClass == uint8_t(AttribClass::Vertex) ? 3 * h.numPrims
+                                : 1;
+        if (e.count != expected) return fail("bad attribute size");
+
+        Pending& p = attribs[{e.attribClass, std::string(e.name)}];
+        if (!p.first)
+        {
+            p.first = &e;
+            p.comps.assign(e.tupleSize, nullptr);
+        }
+        if (e.type != p.first->type || e.tupleSize != p.first->tupleSize || p.comps[e.component])
+            return fail("inconsistent attribute chunks");
+        p.comps[e.component] = &e;
+    }
+    if (!haveTris) return fail("missing triangle chunk");
+
+    for (auto& [key, p] : attribs)
+    {
+        const ChunkEntry& e = *p.first;
+        Attribute a(key.second, AttribType(e.type), e.tupleSize);
+        for (int k = 0; k < e.tupleSize; ++k)
+        {
+            const ChunkEntry* c = p.comps[size_t(k)];
+            if (!c) return fail("missing attribute component");
+            const std::byte* data = base + c->offset;
+            if (a.type() == AttribType::Float)
+                a.setBuffer(k, CowArray<float>::external(reinterpret_cast<const float*>(data), size_t(c->count), owner));
+            else
+                a.setBuffer(k, CowArray<int32_t>::external(reinterpret_cast<const int32_t*>(data), size_t(c->count), owner));
+        }
+        tables[key.first].insert(std::move(a));
+    }
+
+    // tables without attributes still need their element counts
+    const uint64_t counts[4] = {h.numPoints, h.numPrims, 3 * h.numPrims, 1};
+    for (int c = 0; c < 4; ++c)
+        if (tables[c].attributes().empty()) tables[c].resize(size_t(counts[c]));
+
+    const Attribute* P = tables[int(AttribClass::Point)].find("P");
+    if (!P || P->type() != AttribType::Float || P->tupleSize() != 3) return fail("missing P attribute");
+
+    g.pointAttribs = std::move(tables[int(AttribClass::Point)]);
+    g.primAttribs = std::move(tables[int(AttribClass::Prim)]);
+    g.vertexAttribs = std::move(tables[int(AttribClass::Vertex)]);
+    g.detailAttribs = std::move(tables[int(AttribClass::Detail)]);
+    out = std::move(g);
+    return true;
+}
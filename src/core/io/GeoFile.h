@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+
+struct Geometry;
+
+// .hgeo: versioned little-endian binary geometry, laid out so a mapped file
+// can be used in place.
+//
+//   header       64 bytes: "HGEO", version, flags, chunk count, point and
+//                prim counts, chunk table offset, file size
+//   chunk table  64 bytes per chunk: kind (attribute component / triangles),
+//                attribute class, type, tuple size, component, data offset,
+//                element count, checksum, name (up to 31 chars)
+//   data         one section per chunk, 64-byte aligned
+//
+// Each attribute component and the triangle array is one chunk, matching the
+// in-memory SoA layout, so reading maps the file and points the geometry's
+// buffers straight into it. Those buffers are read-only; the first write to
+// one copies it (see CowArray::external).
+
+struct GeoWriteOptions
+{
+    bool checksums = true; // per-chunk 64-bit checksums
+};
+
+struct GeoReadOptions
+{
+    // Verify checksums and triangle indices. Touches every page, so it costs
+    // a full read; off by default, for the disk cache's own files. Readers of
+    // files from elsewhere (the File SOP) must at least check the indices.
+    bool verify = false;
+};
+
+// Writes atomically (uniquely named temporary file + rename), so concurrent
+// writers of the same path never interleave. False with a message on failure.
+bool writeGeo(const Geometry& geo, const std::string& path, std::string& error,
+              const GeoWriteOptions& options = {});
+
+// Maps path and fills out with zero-copy views of it; the mapping lives as
+// long as any buffer referencing it. False with a message on failure.
+bool readGeo(const std::string& path, Geometry& out, std::string& error,
+             const GeoReadOptions& options = {});
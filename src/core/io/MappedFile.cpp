@@ -0,0 +1,109 @@
+#include "core/io/MappedFile.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path, std::string& error)
+{
+    std::shared_ptr<MappedFile> f(new MappedFile());
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        error = "cannot open " + path;
+        return {};
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    f->m_file = file;
+    f->m_size = size_t(size.QuadPart);
+    if (f->m_size == 0) return f;
+
+    f->m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (f->m_mapping)
+    {
+        f->m_data = static_cast<const std::byte*>(MapViewOfFile(f->m_mapping, FILE_MAP_READ, 0, 0, 0));
+        f->m_mapped = f->m_data != nullptr;
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return {};
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        error = "cannot stat " + path;
+        ::close(fd);
+        return {};
+    }
+    f->m_size = size_t(st.st_size);
+    if (f->m_size == 0)
+    {
+        ::close(fd);
+        return f;
+    }
+
+    void* p = mmap(nullptr, f->m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps its own reference
+    if (p != MAP_FAILED)
+    {
+        f->m_data = static_cast<const std::byte*>(p);
+        f->m_mapped = true;
+    }
+#endif
+
+    if (!f->m_mapped)
+    {
+        // e.g. a filesystem without mmap support: plain read
+        std::FILE* in = std::fopen(path.c_str(), "rb");
+        auto* buf = in ? static_cast<std::byte*>(::operator new(f->m_size, std::nothrow)) : nullptr;
+        if (!buf || std::fread(buf, 1, f->m_size, in) != f->m_size)
+        {
+            ::operator delete(buf);
+            if (in) std::fclose(in);
+            error = "cannot read " + path;
+            return {};
+        }
+        std::fclose(in);
+        f->m_data = buf;
+    }
+    return f;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_mapped)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+    }
+    else
+    {
+        ::operator delete(const_cast<std::byte*>(m_data));
+    }
+#if defined(_WIN32)
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// Read-only view of a whole file, memory-mapped where the OS allows it
+// (falls back to reading it into memory). Pages are faulted in on access, so
+// opening is O(1) in the file size.
+class MappedFile
+{
+public:
+    // Null (with a message in error) if the file can't be opened.
+    static std::shared_ptr<const MappedFile> open(const std::string& path, std::string& error);
+
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::byte* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    MappedFile() = default;
+
+    const std::byte* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+#if defined(_WIN32)
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
@@ -0,0 +1,206 @@
+#include "core/io/ObjReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "core/io/MappedFile.h"
+#include "core/io/TextScan.h"
+
+using namespace textscan;
+
+namespace
+{
+    constexpr size_t kChunkBytes = size_t(4) << 20;
+
+    // Per chunk: what pass 1 counted, then where pass 2 writes.
+    struct Chunk
+    {
+        size_t begin = 0, end = 0;
+        size_t points = 0;       // "v" lines
+        size_t tris = 0;         // after fan triangulation
+        int firstVertexValues = 0; // numbers on the chunk's first "v" line (0 = none)
+        size_t pointBase = 0;
+        size_t triBase = 0;
+    };
+
+    bool isKeyword(const char* p, const char* end, char c)
+    {
+        return p + 1 < end && p[0] == c && isSpace(p[1]);
+    }
+
+    bool atLineEnd(const char* p, const char* end)
+    {
+        return p >= end || *p == '\n' || *p == '#'; // a trailing comment ends the values
+    }
+
+    int countValues(const char* p, const char* end)
+    {
+        int n = 0;
+        for (p = skipSpace(p, end); !atLineEnd(p, end); p = skipSpace(skipToken(p, end), end))
+            ++n;
+        return n;
+    }
+
+    void countChunk(const char* data, Chunk& c)
+    {
+        const char* end = data + c.end;
+        for (const char* line = data + c.begin; line < end; line = nextLine(line, end))
+        {
+            const char* p = skipSpace(line, end);
+            if (isKeyword(p, end, 'v'))
+            {
+                if (c.points++ == 0) c.firstVertexValues = countValues(p + 1, end);
+            }
+            else if (isKeyword(p, end, 'f'))
+            {
+                const int corners = countValues(p + 1, end);
+                if (corners > 2) c.tris += size_t(corners - 2);
+            }
+        }
+    }
+
+    struct Buffers
+    {
+        float* P[3];
+        float* Cd[3]; // null without colours
+        Tri* tris;
+        size_t numPoints;
+    };
+
+    // Fills the chunk's slice of the buffers. Null on success, else where it failed.
+    const char* parseChunk(const char* data, const Chunk& c, const Buffers& b)
+    {
+        const char* end = data + c.end;
+        size_t point = c.pointBase;
+        Tri* tri = b.tris + c.triBase;
+
+        for (const char* line = data + c.begin; line < end; line = nextLine(line, end))
+        {
+            const char* p = skipSpace(line, end);
+            if (isKeyword(p, end, 'v'))
+            {
+                ++p;
+                for (int k = 0; k < 3; ++k)
+                    if (!parseNumber(p, end, b.P[k][point])) return line;
+                if (b.Cd[0])
+                {
+                    for (int k = 0; k < 3; ++k)
+                        if (!parseNumber(p, end, b.Cd[k][point])) b.Cd[k][point] = 0.0f;
+                }
+                ++point;
+            }
+            else if (isKeyword(p, end, 'f'))
+            {
+                ++p;
+                // "i", "i/t", "i//n" or "i/t/n"; negative indices count back from
+                // the last vertex defined so far.
+                uint32_t first = 0, prev = 0;
+                int corner = 0;
+                for (p = skipSpace(p, end); !atLineEnd(p, end); p = skipSpace(skipToken(p, end), end))
+                {
+                    long long i;
+                    if (!parseNumber(p, end, i) || i == 0) return line;
+                    const long long idx = i > 0 ? i - 1 : (long long)point + i;
+                    if (idx < 0 || size_t(idx) >= b.numPoints) return line;
+
+                    const uint32_t v = uint32_t(idx);
+                    if (corner == 0) first = v;
+                    else if (corner >= 2) *tri++ = {first, prev, v};
+                    prev = v;
+                    ++corner;
+                }
+            }
+        }
+        return nullptr;
+    }
+}
+
+bool readObj(const std::string& path, Geometry& out, std::string& error, const CookContext& ctx)
+{
+    auto file = MappedFile::open(path, error);
+    if (!file) return false;
+
+    const char* data = reinterpret_cast<const char*>(file->data());
+    const std::vector<size_t> cuts = lineChunks(data, file->size(), kChunkBytes);
+    std::vector<Chunk> chunks(cuts.size() - 1);
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        chunks[i].begin = cuts[i];
+        chunks[i].end = cuts[i + 1];
+    }
+
+    // Pass 1: count, so every buffer is sized once and chunks know where to write.
+    ctx.parallelFor(chunks.size(), 1, [&](size_t b, size_t e)
+    {
+        for (size_t i = b; i < e && !ctx.cancelled(); ++i) countChunk(data, chunks[i]);
+    });
+    if (ctx.cancelled())
+    {
+        error = "cancelled";
+        return false;
+    }
+
+    size_t numPoints = 0, numTris = 0;
+    int vertexValues = 0;
+    for (Chunk& c : chunks)
+    {
+        c.pointBase = numPoints;
+        c.triBase = numTris;
+        numPoints += c.points;
+        numTris += c.tris;
+        if (!vertexValues) vertexValues = c.firstVertexValues;
+    }
+    if (numPoints > std::numeric_limits<uint32_t>::max())
+    {
+        error = path + ": too many points";
+        return false;
+    }
+
+    // Pass 2: parse into the presized buffers.
+    Geometry g;
+    const bool colours = vertexValues >= 6;
+    if (colours) g.pointAttribs.add("Cd", AttribType::Float, 3);
+    g.overwritePoints(numPoints);
+
+    Buffers b{};
+    for (int k = 0; k < 3; ++k)
+    {
+        b.P[k] = g.P().floats(k);
+        b.Cd[k] = colours ? g.pointAttribs.find("Cd")->floats(k) : nullptr;
+    }
+    b.tris = g.overwritePrims(numTris);
+    b.numPoints = numPoints;
+
+    std::mutex errorMutex;
+    const char* bad = nullptr;
+    std::atomic<size_t> done{0};
+    ctx.parallelFor(chunks.size(), 1, [&](size_t cb, size_t ce)
+    {
+        for (size_t i = cb; i < ce && !ctx.cancelled(); ++i)
+        {
+            if (const char* at = parseChunk(data, chunks[i], b))
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!bad || at < bad) bad = at;
+            }
+            ctx.reportProgress(float(done.fetch_add(1, std::memory_order_relaxed) + 1) / float(chunks.size()));
+        }
+    });
+
+    if (ctx.cancelled())
+    {
+        error = "cancelled";
+        return false;
+    }
+    if (bad)
+    {
+        error = path + ": line " + std::to_string(countLines(data, bad) + 1) + ": malformed or out of range";
+        return false;
+    }
+
+    out = std::move(g);
+    return true;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <string>
+
+#include "core/graph/Node.h"
+
+// Wavefront OBJ: vertex positions (plus "v x y z r g b" colours as Cd) and
+// faces, fan-triangulated. Texture coordinates, normals, groups and
+// materials are skipped. Parses in parallel on ctx's pool.
+// False with a message on failure (or if ctx was cancelled).
+bool readObj(const std::string& path, Geometry& out, std::string& error, const CookContext& ctx = {});
@@ -0,0 +1,30 @@
+#include "core/io/ObjWriter.h"
+
+#include <cstdio>
+#include <memory>
+
+#include "core/geo/Geometry.h"
+
+bool writeObj(const Geometry& geo, const std::string& path)
+{
+    std::unique_ptr<FILE, int(*)(FILE*)> f(std::fopen(path.c_str(), "wb"), &std::fclose);
+    if (!f) return false;
+
+    // formatting dominates, so let stdio batch the writes in a big buffer
+    std::setvbuf(f.get(), nullptr, _IOFBF, 1 << 20);
+
+    if (geo.numPoints() > 0)
+    {
+        const Attribute& P = geo.P();
+        const float* px = P.floats(0);
+        const float* py = P.floats(1);
+        const float* pz = P.floats(2);
+        for (size_t i = 0; i < geo.numPoints(); ++i)
+            std::fprintf(f.get(), "v %.9g %.9g %.9g\n", double(px[i]), double(py[i]), double(pz[i]));
+    }
+
+    for (const Tri& t : geo.Tris)
+        std::fprintf(f.get(), "f %u %u %u\n", t.a + 1, t.b + 1, t.c + 1);
+
+    return std::fflush(f.get()) == 0 && !std::ferror(f.get());
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include <string>
+
+class Geometry;
+
+// Wavefront OBJ: positions and triangles only. False if the file couldn't be written.
+bool writeObj(const Geometry& geo, const std::string& path);
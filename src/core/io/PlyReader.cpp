@@ -0,0 +1,665 @@
+#include "core/io/PlyReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "core/io/MappedFile.h"
+#include "core/io/TextScan.h"
+
+using namespace textscan;
+
+namespace
+{
+    constexpr size_t kChunkBytes = size_t(4) << 20;
+    constexpr size_t kBlockRecords = size_t(1) << 16; // binary records per parallel task
+
+    enum class Format { Ascii, BinaryLE, BinaryBE };
+
+    enum class Type : uint8_t { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid };
+
+    // What a property feeds; everything else is skipped.
+    enum class Role : uint8_t { None, X, Y, Z, NX, NY, NZ, Red, Green, Blue, Indices };
+
+    struct Property
+    {
+        Type type = Type::Invalid;
+        bool list = false;
+        Type countType = Type::Invalid;
+        Role role = Role::None;
+    };
+
+    struct Element
+    {
+        std::string name;
+        size_t count = 0;
+        std::vector<Property> props;
+    };
+
+    Type parseType(std::string_view s)
+    {
+        if (s == "char" || s == "int8") return Type::Int8;
+        if (s == "uchar" || s == "uint8") return Type::UInt8;
+        if (s == "short" || s == "int16") return Type::Int16;
+        if (s == "ushort" || s == "uint16") return Type::UInt16;
+        if (s == "int" || s == "int32") return Type::Int32;
+        if (s == "uint" || s == "uint32") return Type::UInt32;
+        if (s == "float" || s == "float32") return Type::Float32;
+        if (s == "double" || s == "float64") return Type::Float64;
+        return Type::Invalid;
+    }
+
+    size_t typeSize(Type t)
+    {
+        switch (t)
+        {
+            case Type::Int8: case Type::UInt8: return 1;
+            case Type::Int16: case Type::UInt16: return 2;
+            case Type::Int32: case Type::UInt32: case Type::Float32: return 4;
+            case Type::Float64: return 8;
+            case Type::Invalid: break;
+        }
+        return 0;
+    }
+
+    Role vertexRole(std::string_view s)
+    {
+        if (s == "x") return Role::X;
+        if (s == "y") return Role::Y;
+        if (s == "z") return Role::Z;
+        if (s == "nx") return Role::NX;
+        if (s == "ny") return Role::NY;
+        if (s == "nz") return Role::NZ;
+        if (s == "red") return Role::Red;
+        if (s == "green") return Role::Green;
+        if (s == "blue") return Role::Blue;
+        return Role::None;
+    }
+
+    template <class T> T load(const std::byte* p, bool swap)
+    {
+        using U = std::conditional_t<sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t,
+                  std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+        U u;
+        std::memcpy(&u, p, sizeof(u));
+        if (swap)
+        {
+            U r = 0;
+            for (size_t i = 0; i < sizeof(U); ++i) r = U((r << 8) | ((u >> (8 * i)) & 0xff));
+            u = r;
+        }
+        T v;
+        std::memcpy(&v, &u, sizeof(v));
+        return v;
+    }
+
+    double loadValue(const std::byte* p, Type t, bool swap)
+    {
+        switch (t)
+        {
+            case Type::Int8: return load<int8_t>(p, swap);
+            case Type::UInt8: return load<uint8_t>(p, swap);
+            case Type::Int16: return load<int16_t>(p, swap);
+            case Type::UInt16: return load<uint16_t>(p, swap);
+            case Type::Int32: return load<int32_t>(p, swap);
+            case Type::UInt32: return load<uint32_t>(p, swap);
+            case Type::Float32: return load<float>(p, swap);
+            case Type::Float64: return load<double>(p, swap);
+            case Type::Invalid: break;
+        }
+        return 0.0;
+    }
+
+    // Destination buffers; pointers are null for absent attributes.
+    struct Buffers
+    {
+        float* P[3] = {};
+        float* N[3] = {};
+        float* Cd[3] = {};
+        float colourScale = 1.0f; // 1/255 for integer colours
+        Tri* tris = nullptr;
+        size_t numPoints = 0;
+    };
+
+    void storeVertexValue(const Buffers& b, Role role, size_t i, double v)
+    {
+        switch (role)
+        {
+            case Role::X: b.P[0][i] = float(v); break;
+            case Role::Y: b.P[1][i] = float(v); break;
+            case Role::Z: b.P[2][i] = float(v); break;
+            case Role::NX: if (b.N[0]) b.N[0][i] = float(v); break;
+            case Role::NY: if (b.N[1]) b.N[1][i] = float(v); break;
+            case Role::NZ: if (b.N[2]) b.N[2][i] = float(v); break;
+            case Role::Red: if (b.Cd[0]) b.Cd[0][i] = float(v) * b.colourScale; break;
+            case Role::Green: if (b.Cd[1]) b.Cd[1][i] = float(v) * b.colourScale; break;
+            case Role::Blue: if (b.Cd[2]) b.Cd[2][i] = float(v) * b.colourScale; break;
+            default: break;
+        }
+    }
+
+    // Fan-triangulates one face, asking get(k) for corners in order; false on
+    // an out-of-range index.
+    template <class GetIndex>
+    bool emitFace(const Buffers& b, size_t corners, GetIndex&& get, Tri*& out)
+    {
+        uint32_t first = 0, prev = 0;
+        for (size_t k = 0; k < corners; ++k)
+        {
+            const double i = get(k);
+            if (!(i >= 0.0 && i < double(b.numPoints))) return false;
+            const uint32_t v = uint32_t(i);
+            if (k == 0) first = v;
+            else if (k >= 2) *out++ = {first, prev, v};
+            prev = v;
+        }
+        return true;
+    }
+
+    struct Header
+    {
+        Format format = Format::Ascii;
+        std::vector<Element> elements;
+        size_t bodyOffset = 0;
+    };
+
+    bool parseHeader(const char* data, size_t size, Header& h, std::string& error)
+    {
+        const char* end = data + size;
+        const char* line = data;
+        bool sawFormat = false;
+        for (int n = 0; line < end; line = nextLine(line, end), ++n)
+        {
+            std::vector<std::string_view> tok;
+            const char* lineEnd = nextLine(line, end);
+            for (const char* p = skipSpace(line, lineEnd); p < lineEnd && *p != '\n'; )
+            {
+                const char* e = skipToken(p, lineEnd);
+                tok.emplace_back(p, size_t(e - p));
+                p = skipSpace(e, lineEnd);
+            }
+
+            if (n == 0)
+            {
+                if (tok.size() != 1 || tok[0] != "ply") { error = "not a PLY file"; return false; }
+                continue;
+            }
+            if (tok.empty() || tok[0] == "comment" || tok[0] == "obj_info") continue;
+
+            if (tok[0] == "format" && tok.size() >= 2)
+            {
+                if (tok[1] == "ascii") h.format = Format::Ascii;
+                else if (tok[1] == "binary_little_endian") h.format = Format::BinaryLE;
+                else if (tok[1] == "binary_big_endian") h.format = Format::BinaryBE;
+                else { error = "unknown PLY format"; return false; }
+                sawFormat = true;
+            }
+            else if (tok[0] == "element" && tok.size() == 3)
+            {
+                Element e;
+                e.name = std::string(tok[1]);
+                long long count = 0;
+                const char* p = tok[2].data();
+                if (!parseNumber(p, tok[2].data() + tok[2].size(), count) || count < 0)
+                {
+                    error = "bad element count";
+                    return false;
+                }
+                e.count = size_t(count);
+                h.elements.push_back(std::move(e));
+            }
+            else if (tok[0] == "property" && !h.elements.empty())
+            {
+                Element& e = h.elements.back();
+                Property p;
+                std::string_view name;
+                if (tok.size() == 5 && tok[1] == "list")
+                {
+                    p.list = true;
+                    p.countType = parseType(tok[2]);
+                    p.type = parseType(tok[3]);
+                    name = tok[4];
+                    if (p.countType == Type::Invalid || p.countType == Type::Float32 || p.countType == Type::Float64)
+                        p.countType = Type::Invalid;
+                }
+                else if (tok.size() == 3)
+                {
+                    p.type = parseType(tok[1]);
+                    name = tok[2];
+                }
+                if (p.type == Type::Invalid || (p.list && p.countType == Type::Invalid))
+                {
+                    error = "unsupported property type";
+                    return false;
+                }
+
+                if (e.name == "vertex" && !p.list) p.role = vertexRole(name);
+                else if (e.name == "face" && p.list && (name == "vertex_indices" || name == "vertex_index"))
+                    p.role = Role::Indices;
+                e.props.push_back(p);
+            }
+            else if (tok[0] == "end_header")
+            {
+                if (!sawFormat) { error = "missing format line"; return false; }
+                h.bodyOffset = size_t(lineEnd - data);
+                return true;
+            }
+            else
+            {
+                error = "malformed header";
+                return false;
+            }
+        }
+        error = "truncated header";
+        return false;
+    }
+
+    // ---- binary ----
+
+    // Bytes in the record at p, or 0 if it's malformed or runs past end.
+    size_t recordSize(const Element& e, const std::byte* p, const std::byte* end, bool swap)
+    {
+        size_t at = 0;
+        const size_t avail = size_t(end - p);
+        for (const Property& prop : e.props)
+        {
+            if (!prop.list)
+            {
+                at += typeSize(prop.type);
+                if (at > avail) return 0;
+                continue;
+            }
+            const size_t cs = typeSize(prop.countType);
+            if (avail - at < cs) return 0;
+            const double n = loadValue(p + at, prop.countType, swap);
+            at += cs;
+            if (!(n >= 0) || n > double(avail - at) / double(typeSize(prop.type))) return 0;
+            at += size_t(n) * typeSize(prop.type);
+        }
+        return at;
+    }
+
+    bool fixedSize(const Element& e, size_t& stride)
+    {
+        stride = 0;
+        for (const Property& p : e.props)
+        {
+            if (p.list) return false;
+            stride += typeSize(p.type);
+        }
+        return true;
+    }
+
+    // Where each block of kBlockRecords starts, plus triangles per block for
+    // faces. Variable-sized elements need one sequential walk for this.
+    struct Layout
+    {
+        std::vector<size_t> blockStart; // byte offsets; size blocks + 1
+        std::vector<size_t> blockTris;  // prefix sums; size blocks + 1
+    };
+
+    bool layoutElement(const Element& e, const std::byte* base, size_t at, size_t size, bool swap, Layout& out)
+    {
+        const size_t blocks = (e.count + kBlockRecords - 1) / kBlockRecords;
+        out.blockStart.assign(blocks + 1, 0);
+        out.blockTris.assign(blocks + 1, 0);
+
+        size_t stride;
+        if (fixedSize(e, stride))
+        {
+            if (stride && e.count > (size - at) / stride) return false;
+            for (size_t b = 0; b <= blocks; ++b)
+                out.blockStart[b] = at + std::min(b * kBlockRecords, e.count) * stride;
+            return true;
+        }
+
+        // only the index list's count byte matters for triangles
+        const Property* indices = nullptr;
+        size_t indicesOffsetFixed = 0;
+        bool indicesAtFixedOffset = true;
+        for (const Property& p : e.props)
+        {
+            if (p.role == Role::Indices) { indices = &p; break; }
+            if (p.list) { indicesAtFixedOffset = false; break; }
+            indicesOffsetFixed += typeSize(p.type);
+        }
+
+        const std::byte* end = base + size;
+        const std::byte* p = base + at;
+        size_t tris = 0;
+        for (size_t r = 0; r < e.count; ++r)
+        {
+            if (r % kBlockRecords == 0)
+            {
+                out.blockStart[r / kBlockRecords] = size_t(p - base);
+                out.blockTris[r / kBlockRecords] = tris;
+            }
+            // measure first: only then is the count known to be inside the file
+            const size_t bytes = recordSize(e, p, end, swap);
+            if (!bytes) return false;
+            if (indices && indicesAtFixedOffset)
+            {
+                const double n = loadValue(p + indicesOffsetFixed, indices->countType, swap);
+                if (n > 2) tris += size_t(n) - 2;
+            }
+            p += bytes;
+        }
+        out.blockStart[blocks] = size_t(p - base);
+        out.blockTris[blocks] = tris;
+
+        // Index list after another list: count triangles in a second walk.
+        if (indices && !indicesAtFixedOffset)
+        {
+            p = base + at;
+            tris = 0;
+            for (size_t r = 0; r < e.count; ++r)
+            {
+                if (r % kBlockRecords == 0) out.blockTris[r / kBlockRecords] = tris;
+                for (const Property& prop : e.props)
+                {
+                    if (!prop.list) { p += typeSize(prop.type); continue; }
+                    const double n = loadValue(p, prop.countType, swap);
+                    if (&prop == indices && n > 2) tris += size_t(n) - 2;
+                    p += typeSize(prop.countType) + size_t(n) * typeSize(prop.type);
+                }
+            }
+            out.blockTris[blocks] = tris;
+        }
+        return true;
+    }
+
+    // Parses records [first, last) starting at byte p. False on a bad index.
+    bool parseBinaryBlock(const Element& e, bool isVertex, const std::byte* p, size_t first, size_t last,
+                          Tri* tri, bool swap, const Buffers& b)
+    {
+        for (size_t r = first; r < last; ++r)
+        {
+            for (const Property& prop : e.props)
+            {
+                if (!prop.list)
+                {
+                    if (isVertex && prop.role != Role::None)
+                        storeVertexValue(b, prop.role, r, loadValue(p, prop.type, swap));
+                    p += typeSize(prop.type);
+                    continue;
+                }
+
+                const size_t n = size_t(loadValue(p, prop.countType, swap));
+                p += typeSize(prop.countType);
+                if (prop.role == Role::Indices)
+                {
+                    const size_t is = typeSize(prop.type);
+                    const bool ok = emitFace(b, n, [&](size_t k) { return loadValue(p + k * is, prop.type, swap); }, tri);
+                    if (!ok) return false;
+                }
+                p += n * typeSize(prop.type);
+            }
+        }
+        return true;
+    }
+
+    // ---- ASCII ----
+
+    struct TextChunk
+    {
+        size_t begin = 0, end = 0;
+        size_t firstLine = 0; // index into the body's lines
+        size_t tris = 0;
+        size_t triBase = 0;
+    };
+
+    // Parses one ASCII record: scalar(role, value) for each scalar property,
+    // face(corners, p) to consume the index list. False if malformed.
+    template <class Scalar, class Face>
+    bool parseTextRecord(const Element& e, const char*& p, const char* end, Scalar&& scalar, Face&& face)
+    {
+        for (const Property& prop : e.props)
+        {
+            double v;
+            if (!parseNumber(p, end, v)) return false;
+            if (!prop.list)
+            {
+                scalar(prop.role, v);
+                continue;
+            }
+            if (v < 0) return false;
+            const size_t n = size_t(v);
+            if (prop.role == Role::Indices)
+            {
+                if (!face(n, p)) return false;
+            }
+            else
+            {
+                for (size_t k = 0; k < n; ++k)
+                    if (!parseNumber(p, end, v)) return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool readPly(const std::string& path, Geometry& out, std::string& error, const CookContext& ctx)
+{
+    auto file = MappedFile::open(path, error);
+    if (!file) return false;
+
+    auto fail = [&](const std::string& msg)
+    {
+        error = path + ": " + msg;
+        return false;
+    };
+    auto cancelled = [&]()
+    {
+        error = "cancelled";
+        return false;
+    };
+
+    const char* text = reinterpret_cast<const char*>(file->data());
+    const std::byte* base = file->data();
+    const size_t size = file->size();
+
+    Header h;
+    std::string headerError;
+    if (!parseHeader(text, size, h, headerError)) return fail(headerError);
+
+    const Element* vertex = nullptr;
+    const Element* face = nullptr;
+    for (const Element& e : h.elements)
+    {
+        if (e.name == "vertex" && !vertex) vertex = &e;
+        else if (e.name == "face" && !face) face = &e;
+    }
+    if (!vertex) return fail("no vertex element");
+    if (vertex->count > std::numeric_limits<uint32_t>::max()) return fail("too many points");
+
+    auto has = [&](Role r)
+    {
+        return std::any_of(vertex->props.begin(), vertex->props.end(), [r](const Property& p) { return p.role == r; });
+    };
+    if (!has(Role::X) || !has(Role::Y) || !has(Role::Z)) return fail("vertex element has no x/y/z");
+    const bool normals = has(Role::NX) && has(Role::NY) && has(Role::NZ);
+    const bool colours = has(Role::Red) && has(Role::Green) && has(Role::Blue);
+
+    Geometry g;
+    if (normals) g.pointAttribs.add("N", AttribType::Float, 3);
+    if (colours) g.pointAttribs.add("Cd", AttribType::Float, 3);
+    g.overwritePoints(vertex->count);
+
+    Buffers b;
+    b.numPoints = vertex->count;
+    for (int k = 0; k < 3; ++k)
+    {
+        b.P[k] = g.P().floats(k);
+        if (normals) b.N[k] = g.pointAttribs.find("N")->floats(k);
+        if (colours) b.Cd[k] = g.pointAttribs.find("Cd")->floats(k);
+    }
+    for (const Property& p : vertex->props)
+        if (p.role == Role::Red && p.type != Type::Float32 && p.type != Type::Float64) b.colourScale = 1.0f / 255.0f;
+
+    std::atomic<bool> bad{false};
+
+    if (h.format != Format::Ascii)
+    {
+        const bool swap = (h.format == Format::BinaryBE) != (std::endian::native == std::endian::big);
+
+        size_t at = h.bodyOffset;
+        for (const Element& e : h.elements)
+        {
+            Layout layout;
+            if (!layoutElement(e, base, at, size, swap, layout)) return fail("truncated " + e.name + " data");
+
+            const bool isVertex = &e == vertex;
+            if (isVertex || &e == face)
+            {
+                Tri* tris = &e == face ? g.overwritePrims(layout.blockTris.back()) : nullptr;
+
+                const size_t blocks = layout.blockStart.size() - 1;
+                ctx.parallelFor(blocks, 1, [&](size_t bb, size_t be)
+                {
+                    for (size_t k = bb; k < be && !ctx.cancelled(); ++k)
+                    {
+                        const size_t first = k * kBlockRecords;
+                        const size_t last = std::min(e.count, first + kBlockRecords);
+                        if (!parseBinaryBlock(e, isVertex, base + layout.blockStart[k], first, last,
+                                              tris ? tris + layout.blockTris[k] : nullptr, swap, b))
+                            bad.store(true, std::memory_order_relaxed);
+                    }
+                });
+                if (ctx.cancelled()) return cancelled();
+                if (bad.load()) return fail("face index out of range");
+            }
+            at = layout.blockStart.back();
+        }
+
+        out = std::move(g);
+        return true;
+    }
+
+    // ASCII: one record per line, elements back to back. Pass 1 counts lines
+    // per chunk, which places every chunk within the elements; pass 2 counts
+    // each chunk's triangles; pass 3 parses.
+    const char* body = text + h.bodyOffset;
+    const size_t bodySize = size - h.bodyOffset;
+    const std::vector<size_t> cuts = lineChunks(body, bodySize, kChunkBytes);
+    std::vector<TextChunk> chunks(cuts.size() - 1);
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        chunks[i].begin = cuts[i];
+        chunks[i].end = cuts[i + 1];
+    }
+
+    std::vector<size_t> lineCounts(chunks.size());
+    ctx.parallelFor(chunks.size(), 1, [&](size_t cb, size_t ce)
+    {
+        for (size_t i = cb; i < ce; ++i)
+            lineCounts[i] = countLines(body + chunks[i].begin, body + chunks[i].end);
+    });
+    for (size_t i = 1; i < chunks.size(); ++i)
+        chunks[i].firstLine = chunks[i - 1].firstLine + lineCounts[i - 1];
+
+    // element index of each body line range
+    std::vector<size_t> elementFirstLine;
+    size_t lines = 0;
+    for (const Element& e : h.elements)
+    {
+        elementFirstLine.push_back(lines);
+        lines += e.count;
+    }
+    const size_t totalLines = chunks.empty() ? 0 : chunks.back().firstLine + lineCounts.back()
+                            + (bodySize && body[bodySize - 1] != '\n' ? 1 : 0);
+    if (totalLines < lines) return fail("truncated data");
+
+    auto elementAt = [&](size_t line) -> const Element*
+    {
+        const size_t k = size_t(std::upper_bound(elementFirstLine.begin(), elementFirstLine.end(), line)
+                                - elementFirstLine.begin()) - 1;
+        return line < lines ? &h.elements[k] : nullptr;
+    };
+
+    // Walks the chunk's lines that belong to vertex or face records.
+    auto forEachRecord = [&](const TextChunk& c, auto&& fn)
+    {
+        const char* end = body + c.end;
+        size_t line = c.firstLine;
+        for (const char* p = body + c.begin; p < end && line < lines; p = nextLine(p, end), ++line)
+        {
+            const Element* e = elementAt(line);
+            if (e == vertex || e == face)
+                if (!fn(*e, line - elementFirstLine[size_t(e - h.elements.data())], p, nextLine(p, end)))
+                    return false;
+        }
+        return true;
+    };
+
+    auto noScalar = [](Role, double) {};
+
+    if (face)
+    {
+        ctx.parallelFor(chunks.size(), 1, [&](size_t cb, size_t ce)
+        {
+            for (size_t i = cb; i < ce && !ctx.cancelled(); ++i)
+            {
+                TextChunk& c = chunks[i];
+                const bool ok = forEachRecord(c, [&](const Element& e, size_t, const char* p, const char* end)
+                {
+                    if (&e != face) return true;
+                    return parseTextRecord(e, p, end, noScalar, [&](size_t n, const char*& q)
+                    {
+                        double v;
+                        for (size_t k = 0; k < n; ++k)
+                            if (!parseNumber(q, end, v)) return false;
+                        if (n > 2) c.tris += n - 2;
+                        return true;
+                    });
+                });
+                if (!ok) bad.store(true, std::memory_order_relaxed);
+            }
+        });
+        if (ctx.cancelled()) return cancelled();
+        if (bad.load()) return fail("malformed face");
+    }
+
+    size_t numTris = 0;
+    for (TextChunk& c : chunks)
+    {
+        c.triBase = numTris;
+        numTris += c.tris;
+    }
+    b.tris = g.overwritePrims(numTris);
+
+    std::atomic<size_t> done{0};
+    ctx.parallelFor(chunks.size(), 1, [&](size_t cb, size_t ce)
+    {
+        for (size_t i = cb; i < ce && !ctx.cancelled(); ++i)
+        {
+            const TextChunk& c = chunks[i];
+            Tri* tri = b.tris + c.triBase;
+            const bool ok = forEachRecord(c, [&](const Element& e, size_t index, const char* p, const char* end)
+            {
+                const bool isVertex = &e == vertex;
+                return parseTextRecord(e, p, end,
+                    [&](Role role, double v) { if (isVertex) storeVertexValue(b, role, index, v); },
+                    [&](size_t n, const char*& q)
+                    {
+                        // corners come in order, so they can be parsed as the fan needs them
+                        return emitFace(b, n, [&](size_t)
+                        {
+                            double v;
+                            return parseNumber(q, end, v) ? v : -1.0;
+                        }, tri);
+                    });
+            });
+            if (!ok) bad.store(true, std::memory_order_relaxed);
+            ctx.reportProgress(float(done.fetch_add(1, std::memory_order_relaxed) + 1) / float(chunks.size()));
+        }
+    });
+    if (ctx.cancelled()) return cancelled();
+    if (bad.load()) return fail("malformed record or face index out of range");
+
+    out = std::move(g);
+    return true;
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+#include "core/graph/Node.h"
+
+// Stanford PLY, ASCII or binary (either byte order): vertex x/y/z, plus
+// nx/ny/nz as N and red/green/blue as Cd when present, and faces
+// (vertex_indices / vertex_index), fan-triangulated. Other elements and
+// properties are skipped. Parses in parallel on ctx's pool.
+// False with a message on failure (or if ctx was cancelled).
+bool readPly(const std::string& path, Geometry& out, std::string& error, const CookContext& ctx = {});
@@ -0,0 +1,74 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+// Small helpers for the text importers: they parse straight out of a mapped
+// file with from_chars, chunked on line boundaries so chunks can go to the pool.
+namespace textscan
+{
+    inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    inline const char* skipSpace(const char* p, const char* end)
+    {
+        while (p < end && isSpace(*p)) ++p;
+        return p;
+    }
+
+    inline const char* skipToken(const char* p, const char* end)
+    {
+        while (p < end && !isSpace(*p) && *p != '\n') ++p;
+        return p;
+    }
+
+    // Start of the next line (or end).
+    inline const char* nextLine(const char* p, const char* end)
+    {
+        const void* nl = std::memchr(p, '\n', size_t(end - p));
+        return nl ? static_cast<const char*>(nl) + 1 : end;
+    }
+
+    inline size_t countLines(const char* p, const char* end)
+    {
+        size_t n = 0;
+        while ((p = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)))) != nullptr)
+        {
+            ++n;
+            ++p;
+        }
+        return n;
+    }
+
+    // Boundaries of ~chunkBytes pieces of [0, size), each ending just after a
+    // newline. Always starts with 0 and ends with size.
+    inline std::vector<size_t> lineChunks(const char* data, size_t size, size_t chunkBytes)
+    {
+        std::vector<size_t> cuts{0};
+        size_t at = 0;
+        while (size - at > chunkBytes)
+        {
+            const char* p = nextLine(data + at + chunkBytes, data + size);
+            at = size_t(p - data);
+            if (at < size) cuts.push_back(at);
+        }
+        cuts.push_back(size);
+        return cuts;
+    }
+
+    // Number at p (after spaces); advances p. Out-of-range values (denormals,
+    // huge exponents) parse as 0 rather than failing the file.
+    template <class T> bool parseNumber(const char*& p, const char* end, T& v)
+    {
+        p = skipSpace(p, end);
+        if (p < end && *p == '+') ++p; // from_chars doesn't take a leading '+'
+        v = T(0);
+        const auto r = std::from_chars(p, end, v);
+        if (r.ec == std::errc::invalid_argument) return false;
+        if (r.ec == std::errc::result_out_of_range) v = T(0);
+        p = r.ptr;
+        return true;
+    }
+}
@@ -0,0 +1,19 @@
+#include "core/ops/Builtins.h"
+
+#include "core/graph/NodeRegistry.h"
+#include "core/ops/FileSop.h"
+#include "core/ops/GridSop.h"
+#include "core/ops/MergeSop.h"
+#include "core/ops/NullSop.h"
+#include "core/ops/TransformSop.h"
+#include "core/ops/WaveSop.h"
+
+void registerBuiltinSops(NodeRegistry& registry)
+{
+    registry.registerType("Grid", [](NodeId id){ return std::make_unique<GridSop>(id); });
+    registry.registerType("Transform", [](NodeId id){ return std::make_unique<TransformSop>(id); });
+    registry.registerType("Merge", [](NodeId id){ return std::make_unique<MergeSop>(id); });
+    registry.registerType("Null", [](NodeId id){ return std::make_unique<NullSop>(id); });
+    registry.registerType("File", [](NodeId id){ return std::make_unique<FileSop>(id); });
+    registry.registerType("Wave", [](NodeId id){ return std::make_unique<WaveSop>(id); });
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+class NodeRegistry;
+
+// Registers every SOP that ships with the engine (Grid, Transform, Merge, Null).
+void registerBuiltinSops(NodeRegistry& registry);
@@ -0,0 +1,108 @@
+#include "core/ops/FileSop.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+
+#include "core/io/GeoFile.h"
+#include "core/io/ObjReader.h"
+#include "core/io/PlyReader.h"
+#include "core/util/Hash.h"
+
+namespace
+{
+    // Our own cache files are read unchecked (see GeoReadOptions), but a File
+    // can point at any .hgeo: out-of-range indices would reach the viewport's
+    // draw calls. One pass over the triangles; checksums stay optional.
+    bool indicesInRange(const Geometry& g, const CookContext& ctx)
+    {
+        const Tri* tris = g.Tris.data();
+        const size_t points = g.numPoints();
+        std::atomic<bool> bad{false};
+        ctx.parallelFor(g.Tris.size(), size_t(1) << 16, [&](size_t begin, size_t end)
+        {
+            bool local = false;
+            for (size_t i = begin; i < end; ++i)
+                local |= tris[i].a >= points || tris[i].b >= points || tris[i].c >= points;
+            if (local) bad = true;
+        });
+        return !bad;
+    }
+
+    const ParamLayout& layout()
+    {
+        static const ParamLayout params = {
+            {.name = "path", .label = "File", .type = ParamType::String,
+             .fileFilter = "Geometry (*.hgeo *.obj *.ply);;All files (*)"},
+        };
+        return params;
+    }
+}
+
+FileSop::FileSop(NodeId id) : Node(id, layout())
+{
+    setName("file1");
+}
+
+void FileSop::hashParams(Hasher& h) const
+{
+    Node::hashParams(h);
+
+    const std::string& path = params().getString(Path);
+
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    h.add(uint64_t(ec ? 0 : size));
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    h.add(int64_t(ec ? 0 : mtime.time_since_epoch().count()));
+}
+
+uint64_t FileSop::stateHash() const
+{
+    Hasher h;
+    hashParams(h);
+    return h.value();
+}
+
+Geometry FileSop::cook(const CookContext& ctx,
+                       const std::vector<std::shared_ptr<const Geometry>>&) const
+{
+    Geometry g;
+    std::string error;
+    const std::string& path = params().getString(Path);
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+
+    bool ok = false;
+    if (path.empty()) error = "no file";
+    else if (ext == ".hgeo")
+    {
+        ok = readGeo(path, g, error);
+        if (ok && !indicesInRange(g, ctx))
+        {
+            ok = false;
+            error = path + ": triangle index out of range";
+        }
+    }
+    else if (ext == ".obj") ok = readObj(path, g, error, ctx);
+    else if (ext == ".ply") ok = readPly(path, g, error, ctx);
+    else error = "unsupported file type: " + path;
+    if (!ok) g = Geometry();
+    if (ctx.cancelled()) return g; // thrown away by the cooker; not a verdict on the file
+    if (!ok && error.empty()) error = "cannot read " + path;
+
+    const uint64_t state = stateHash();
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    if (ok) m_errors.erase(state);
+    else m_errors[state] = std::move(error);
+    return g;
+}
+
+std::string FileSop::cookError() const
+{
+    const uint64_t state = stateHash();
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    auto it = m_errors.find(state);
+    return it == m_errors.end() ? std::string() : it->second;
+}
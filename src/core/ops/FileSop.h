@@ -0,0 +1,38 @@
+#pragma once
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "core/graph/Node.h"
+
+// Loads geometry from disk: .hgeo, .obj or .ply by extension. .hgeo files
+// are mapped, not read: the result shares the file's pages until something
+// downstream writes to it. The text formats parse on the cook's pool.
+class FileSop final : public Node
+{
+public:
+    explicit FileSop(NodeId id);
+
+    const char* typeName() const override { return "File"; }
+    int maxInputs() const override { return 0; }
+
+    enum Param : size_t { Path };
+
+    // Adds the file's size and modification time, so a file edited on disk
+    // cooks again on the next evaluation.
+    void hashParams(Hasher& h) const override;
+
+    // Empty geometry (and a cookError()) if the file can't be read.
+    Geometry cook(const CookContext&,
+                  const std::vector<std::shared_ptr<const Geometry>>&) const override;
+
+    std::string cookError() const override;
+
+private:
+    // Failures by file state (the hashParams() hash): a cached result of a
+    // state cooked earlier still reports its error.
+    mutable std::mutex m_errorMutex;
+    mutable std::unordered_map<uint64_t, std::string> m_errors;
+
+    uint64_t stateHash() const;
+};
@@ -1,47 +1,105 @@
 #include "core/ops/GridSop.h"
 
-GridSop::GridSop(NodeId id) : Node(id)
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    const ParamLayout& layout()
+    {
+        static const ParamLayout params = {
+            {.name = "rows", .label = "Rows", .type = ParamType::Int, .def = {20}, .min = 2, .max = 20000},
+            {.name = "cols", .label = "Cols", .type = ParamType::Int, .def = {20}, .min = 2, .max = 20000},
+            {.name = "size", .label = "Size", .type = ParamType::Float, .def = {1}, .min = 0.01f, .max = 1000},
+        };
+        return params;
+    }
+}
+
+GridSop::GridSop(NodeId id) : Node(id, layout())
 {
     setName("grid1");
 }
 
-Geometry GridSop::cook(const CookContext&,
+bool GridSop::hasPreview() const
+{
+    const size_t r = size_t(std::max(params().getInt(Rows), 2));
+    const size_t c = size_t(std::max(params().getInt(Cols), 2));
+    return r * c > kPreviewPoints;
+}
+
+Geometry GridSop::cook(const CookContext& ctx,
                        const std::vector<std::shared_ptr<const Geometry>>&) const
 {
     Geometry g;
-    const int r = (rows < 2) ? 2 : rows;
-    const int c = (cols < 2) ? 2 : cols;
+    size_t r = size_t(std::max(params().getInt(Rows), 2));
+    size_t c = size_t(std::max(params().getInt(Cols), 2));
+    const float size = params().getFloat(Size);
+
+    // Same shape, fewer points: keep the aspect of the full-resolution grid.
+    if (ctx.preview && hasPreview())
+    {
+        const double s = std::sqrt(double(kPreviewPoints) / double(r * c));
+        r = std::max<size_t>(2, size_t(double(r) * s));
+        c = std::max<size_t>(2, size_t(double(c) * s));
+    }
 
-    g.P.reserve(r * c);
+    // point indices are 32-bit
+    r = std::min(r, size_t(std::numeric_limits<uint32_t>::max()) / c);
 
+    // Size both arrays exactly once; every element is written below.
+    g.overwritePoints(r * c);
+    Attribute& P = g.P();
+    float* px = P.overwriteFloats(0);
+    float* py = P.overwriteFloats(1);
+    float* pz = P.overwriteFloats(2);
+    Tri* tris = g.overwritePrims((r - 1) * (c - 1) * 2);
+
+    // X is the same for every row: compute it once and copy.
     const float half = size * 0.5f;
-    for (int y = 0; y < r; ++y)
-    {
-        const float ty = float(y) / float(r - 1);
-        const float py = -half + ty * size;
+    std::vector<float> rowX(c);
+    for (size_t x = 0; x < c; ++x)
+        rowX[x] = -half + (float(x) / float(c - 1)) * size;
 
-        for (int x = 0; x < c; ++x)
-        {
-            const float tx = float(x) / float(c - 1);
-            const float px = -half + tx * size;
-            g.P.push_back({px, 0.0f, py});
-        }
-    }
+    // Rows are independent: a chunk writes its rows' points and the quads
+    // below them. ~64k points per chunk.
+    const size_t grain = std::max<size_t>(1, (size_t(1) << 16) / c);
+    std::atomic<size_t> rowsDone{0};
 
-    // Triangulate grid
-    for (int y = 0; y < r - 1; ++y)
+    ctx.parallelFor(r, grain, [&](size_t y0, size_t y1)
     {
-        for (int x = 0; x < c - 1; ++x)
+        if (ctx.cancelled()) return;
+
+        for (size_t y = y0; y < y1; ++y)
         {
-            const uint32_t i0 = uint32_t(y * c + x);
-            const uint32_t i1 = uint32_t(y * c + (x + 1));
-            const uint32_t i2 = uint32_t((y + 1) * c + x);
-            const uint32_t i3 = uint32_t((y + 1) * c + (x + 1));
+            const size_t row = y * c;
+            const float pv = -half + (float(y) / float(r - 1)) * size;
 
-            g.Tris.push_back({i0, i2, i1});
-            g.Tris.push_back({i1, i2, i3});
+            std::memcpy(px + row, rowX.data(), c * sizeof(float));
+            std::fill_n(py + row, c, 0.0f);
+            std::fill_n(pz + row, c, pv);
+
+            if (y + 1 == r) continue; // last row has no quads below it
+
+            Tri* t = tris + y * (c - 1) * 2;
+            for (size_t x = 0; x < c - 1; ++x, t += 2)
+            {
+                const uint32_t i0 = uint32_t(row + x);
+                const uint32_t i1 = i0 + 1;
+                const uint32_t i2 = uint32_t(row + c + x);
+                const uint32_t i3 = i2 + 1;
+
+                t[0] = {i0, i2, i1};
+                t[1] = {i1, i2, i3};
+            }
         }
-    }
+
+        const size_t done = rowsDone.fetch_add(y1 - y0, std::memory_order_relaxed) + (y1 - y0);
+        ctx.reportProgress(float(done) / float(r));
+    });
 
     return g;
-}
\ No newline at end of file
+}
@@ -7,10 +7,14 @@ public:
     explicit GridSop(NodeId id);
 
     const char* typeName() const override { return "Grid"; }
+    int maxInputs() const override { return 0; }
 
-    int rows = 20;
-    int cols = 20;
-    float size = 1.0f;
+    // Parameter indices, in layout order.
+    enum Param : size_t { Rows, Cols, Size };
+
+    // Past this many points a preview cook scales rows and cols down.
+    static constexpr size_t kPreviewPoints = size_t(1) << 16;
+    bool hasPreview() const override;
 
     Geometry cook(const CookContext&,
                   const std::vector<std::shared_ptr<const Geometry>>&) const override;
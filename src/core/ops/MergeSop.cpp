@@ -1,33 +1,183 @@
 #include "core/ops/MergeSop.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "core/geo/PointKernels.h"
+
+namespace
+{
+    static_assert(sizeof(Tri) == 3 * sizeof(uint32_t), "Tri is copied as a flat index array");
+
+    // One contiguous run of output: copied from src (zeroed when src is null),
+    // or for index buffers copied with `offset` added to every index.
+    struct CopyJob
+    {
+        std::byte* dst = nullptr;
+        const std::byte* src = nullptr;
+        size_t bytes = 0;
+        bool indices = false;
+        uint32_t offset = 0;
+    };
+
+    // Big enough to amortise scheduling, small enough to balance uneven inputs.
+    constexpr size_t kJobBytes = size_t(1) << 20;
+
+    void addJob(std::vector<CopyJob>& jobs, void* dst, const void* src, size_t bytes,
+                bool indices = false, uint32_t offset = 0)
+    {
+        auto* d = static_cast<std::byte*>(dst);
+        auto* s = static_cast<const std::byte*>(src);
+        for (size_t at = 0; at < bytes; at += kJobBytes)
+        {
+            const size_t n = std::min(kJobBytes, bytes - at); // kJobBytes keeps 4-byte alignment
+            jobs.push_back({d + at, s ? s + at : nullptr, n, indices, offset});
+        }
+    }
+
+    void runJob(const CopyJob& j)
+    {
+        if (j.indices)
+            offsetIndices(reinterpret_cast<const uint32_t*>(j.src), reinterpret_cast<uint32_t*>(j.dst),
+                          j.bytes / sizeof(uint32_t), j.offset);
+        else if (j.src)
+            std::memcpy(j.dst, j.src, j.bytes);
+        else
+            std::memset(j.dst, 0, j.bytes);
+    }
+
+    // Output layout for one attribute class: the union of the inputs'
+    // attributes, first definition of a name winning. Allocated once.
+    void layoutTable(AttribTable& out, const std::vector<const AttribTable*>& ins, size_t total)
+    {
+        for (const AttribTable* in : ins)
+            for (const Attribute& a : in->attributes())
+                if (!out.find(a.name())) out.add(a.name(), a.type(), a.tupleSize());
+        out.overwrite(total);
+    }
+
+    // Copy jobs for every component of every attribute in out, one range per
+    // input; inputs lacking an attribute (or with a clashing one) get zeros.
+    void planTable(std::vector<CopyJob>& jobs, AttribTable& out,
+                   const std::vector<const AttribTable*>& ins, const std::vector<size_t>& offsets)
+    {
+        for (Attribute& d : out.attributes())
+        {
+            for (size_t i = 0; i < ins.size(); ++i)
+            {
+                const Attribute* s = ins[i]->find(d.name());
+                if (s && (s->type() != d.type() || s->tupleSize() != d.tupleSize())) s = nullptr;
+
+                const size_t count = ins[i]->size();
+                for (int k = 0; k < d.tupleSize(); ++k)
+                {
+                    if (d.type() == AttribType::Float)
+                        addJob(jobs, d.floats(k) + offsets[i], s ? s->floats(k) : nullptr, count * sizeof(float));
+                    else
+                        addJob(jobs, d.ints(k) + offsets[i], s ? s->ints(k) : nullptr, count * sizeof(int32_t));
+                }
+            }
+        }
+    }
+}
+
 MergeSop::MergeSop(NodeId id) : Node(id)
 {
     setName("merge1");
 }
 
-Geometry MergeSop::cook(const CookContext&,
+Geometry MergeSop::cook(const CookContext& ctx,
                         const std::vector<std::shared_ptr<const Geometry>>& inputs) const
 {
     Geometry out;
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        m_lastError.clear();
+    }
 
-    uint32_t pointOffset = 0;
+    std::vector<const Geometry*> ins;
+    ins.reserve(inputs.size());
     for (auto& in : inputs)
+        if (in) ins.push_back(in.get());
+
+    if (ins.empty()) return out;
+
+    // A single input passes through, sharing its buffers.
+    if (ins.size() == 1) return *ins[0];
+
+    // Prefix sums: where each input lands in the output.
+    std::vector<size_t> pointOffsets(ins.size()), primOffsets(ins.size()), vertexOffsets(ins.size());
+    size_t numPoints = 0, numPrims = 0;
+    for (size_t i = 0; i < ins.size(); ++i)
+    {
+        pointOffsets[i] = numPoints;
+        primOffsets[i] = numPrims;
+        vertexOffsets[i] = numPrims * 3;
+        numPoints += ins[i]->numPoints();
+        numPrims += ins[i]->numPrims();
+    }
+
+    // Triangle indices are 32-bit: offsetting them past that would wrap into
+    // valid-looking but wrong triangles.
+    if (numPoints > std::numeric_limits<uint32_t>::max())
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        m_lastError = std::to_string(numPoints) + " points: more than 32-bit indices can address";
+        return out;
+    }
+
+    std::vector<const AttribTable*> points, prims, vertices;
+    for (const Geometry* g : ins)
     {
-        if (!in) continue;
-        // append points
-        out.P.insert(out.P.end(), in->P.begin(), in->P.end());
+        points.push_back(&g->pointAttribs);
+        prims.push_back(&g->primAttribs);
+        vertices.push_back(&g->vertexAttribs);
+    }
+
+    // Allocate everything once, then fill it with independent copy jobs.
+    layoutTable(out.pointAttribs, points, numPoints);
+    Tri* tris = out.overwritePrims(numPrims);
+    layoutTable(out.primAttribs, prims, numPrims);
+    layoutTable(out.vertexAttribs, vertices, numPrims * 3);
+
+    std::vector<CopyJob> jobs;
+    planTable(jobs, out.pointAttribs, points, pointOffsets);
+    planTable(jobs, out.primAttribs, prims, primOffsets);
+    planTable(jobs, out.vertexAttribs, vertices, vertexOffsets);
+    for (size_t i = 0; i < ins.size(); ++i)
+        addJob(jobs, tris + primOffsets[i], ins[i]->Tris.data(), ins[i]->numPrims() * sizeof(Tri),
+               true, uint32_t(pointOffsets[i]));
+
+    ctx.reportProgress(0.1f);
+
+    ctx.parallelFor(jobs.size(), 4, [&](size_t begin, size_t end)
+    {
+        if (ctx.cancelled()) return;
+        for (size_t j = begin; j < end; ++j) runJob(jobs[j]);
+    });
 
-        // append tris with offset
-        for (auto t : in->Tris)
+    // detail: first input to define an attribute wins
+    for (const Geometry* g : ins)
+    {
+        for (const Attribute& a : g->detailAttribs.attributes())
         {
-            t.a += pointOffset;
-            t.b += pointOffset;
-            t.c += pointOffset;
-            out.Tris.push_back(t);
+            if (out.detailAttribs.find(a.name())) continue;
+            Attribute& d = out.detailAttribs.add(a.name(), a.type(), a.tupleSize());
+            for (int k = 0; k < a.tupleSize(); ++k)
+            {
+                if (a.type() == AttribType::Float) d.floats(k)[0] = a.floats(k)[0];
+                else d.ints(k)[0] = a.ints(k)[0];
+            }
         }
-
-        pointOffset += uint32_t(in->P.size());
     }
 
+    ctx.reportProgress(1.0f);
     return out;
-}
\ No newline at end of file
+}
+
+std::string MergeSop::cookError() const
+{
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    return m_lastError;
+}
@@ -1,4 +1,7 @@
 #pragma once
+#include <mutex>
+#include <string>
+
 #include "core/graph/Node.h"
 
 class MergeSop final : public Node
@@ -7,7 +10,17 @@ public:
     explicit MergeSop(NodeId id);
 
     const char* typeName() const override { return "Merge"; }
+    int maxInputs() const override { return -1; }
 
+    // Empty geometry (and a cookError()) if the merged points wouldn't fit
+    // 32-bit point indices.
     Geometry cook(const CookContext&,
                   const std::vector<std::shared_ptr<const Geometry>>& inputs) const override;
+
+    // Of the last cook: the failure depends on the inputs, not the parameters.
+    std::string cookError() const override;
+
+private:
+    mutable std::mutex m_errorMutex;
+    mutable std::string m_lastError;
 };
\ No newline at end of file
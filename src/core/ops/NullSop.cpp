@@ -9,5 +9,5 @@ Geometry NullSop::cook(const CookContext&,
                        const std::vector<std::shared_ptr<const Geometry>>& inputs) const
 {
     if (inputs.empty() || !inputs[0]) return {};
-    return *inputs[0];
+    return *inputs[0]; // shares the input's buffers, no deep copy
 }
\ No newline at end of file
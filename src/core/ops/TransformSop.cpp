@@ -1,22 +1,94 @@
 #include "core/ops/TransformSop.h"
 
-TransformSop::TransformSop(NodeId id) : Node(id)
+#include "core/geo/PointKernels.h"
+
+namespace
+{
+    const ParamLayout& layout()
+    {
+        static const ParamLayout params = {
+            {.name = "xformOrder", .label = "Transform Order", .type = ParamType::Menu,
+             .items = {"Scale Rot Trans", "Scale Trans Rot", "Rot Scale Trans",
+                       "Rot Trans Scale", "Trans Scale Rot", "Trans Rot Scale"}},
+            {.name = "rotateOrder", .label = "Rotate Order", .type = ParamType::Menu,
+             .items = {"XYZ", "XZY", "YXZ", "YZX", "ZXY", "ZYX"}},
+            {.name = "translate", .label = "Translate", .type = ParamType::Vec3, .min = -1e6f, .max = 1e6f},
+            {.name = "rotate", .label = "Rotate", .type = ParamType::Vec3, .min = -3600, .max = 3600},
+            {.name = "scale", .label = "Scale", .type = ParamType::Vec3, .def = {1, 1, 1}, .min = -1e6f, .max = 1e6f},
+            {.name = "uniformScale", .label = "Uniform Scale", .type = ParamType::Float, .def = {1},
+             .min = -1e6f, .max = 1e6f},
+            {.name = "pivot", .label = "Pivot", .type = ParamType::Vec3, .min = -1e6f, .max = 1e6f},
+        };
+        return params;
+    }
+}
+
+TransformSop::TransformSop(NodeId id) : Node(id, layout())
 {
     setName("xform1");
 }
 
-Geometry TransformSop::cook(const CookContext&,
+Mat4 TransformSop::matrix() const
+{
+    // rotation axes in application order, e.g. XYZ -> X first
+    static const int kAxes[6][3] = {{0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0}};
+    const ParamSet& p = params();
+    const Vec3 rotate = p.getVec3(Rotate);
+    const Vec3 scale = p.getVec3(Scale);
+    const Vec3 pivot = p.getVec3(Pivot);
+    const float uniformScale = p.getFloat(UniformScale);
+    const float angles[3] = {rotate.x, rotate.y, rotate.z};
+
+    Mat4 R;
+    for (int axis : kAxes[p.getInt(RotOrder)])
+        R = Mat4::rotate(axis, angles[axis]) * R;
+
+    const Mat4 S = Mat4::scale({scale.x * uniformScale, scale.y * uniformScale, scale.z * uniformScale});
+    const Mat4 T = Mat4::translate(p.getVec3(Translate));
+
+    // steps in application order: 0 = S, 1 = R, 2 = T
+    static const int kSteps[6][3] = {{0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0}};
+    const Mat4* steps[3] = {&S, &R, &T};
+
+    Mat4 M;
+    for (int s : kSteps[p.getInt(Order)])
+        M = *steps[s] * M;
+
+    return Mat4::translate(pivot) * M * Mat4::translate({-pivot.x, -pivot.y, -pivot.z});
+}
+
+Geometry TransformSop::cook(const CookContext& ctx,
                             const std::vector<std::shared_ptr<const Geometry>>& inputs) const
 {
     Geometry out;
     if (inputs.empty() || !inputs[0]) return out;
 
-    out = *inputs[0]; // copy (MVP)
-    for (auto& p : out.P)
+    // Share everything with the input (topology, other attributes); only P
+    // gets new storage, written straight from the input's buffers.
+    const Geometry& in = *inputs[0];
+    out = in;
+    if (ctx.cancelled()) return out;
+
+    const Mat4 M = matrix();
+
+    const Attribute& src = in.P();
+    Attribute& dst = out.P();
+    const float* sx = src.floats(0);
+    const float* sy = src.floats(1);
+    const float* sz = src.floats(2);
+    float* dx = dst.overwriteFloats(0);
+    float* dy = dst.overwriteFloats(1);
+    float* dz = dst.overwriteFloats(2);
+
+    // Memory bound: chunks big enough to amortise scheduling, small enough
+    // to spread a million points over every core.
+    constexpr size_t kGrain = 1 << 16;
+    ctx.parallelFor(src.size(), kGrain, [&](size_t begin, size_t end)
     {
-        p.x = p.x * uniformScale + translate.x;
-        p.y = p.y * uniformScale + translate.y;
-        p.z = p.z * uniformScale + translate.z;
-    }
+        if (ctx.cancelled()) return;
+        transformPoints(M, sx + begin, sy + begin, sz + begin,
+                        dx + begin, dy + begin, dz + begin, end - begin);
+    });
+
     return out;
-}
\ No newline at end of file
+}
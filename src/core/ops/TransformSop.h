@@ -1,5 +1,6 @@
 #pragma once
 #include "core/graph/Node.h"
+#include "core/geo/Mat4.h"
 
 class TransformSop final : public Node
 {
@@ -8,9 +9,18 @@ public:
 
     const char* typeName() const override { return "Transform"; }
 
-    Vec3 translate{0,0,0};
-    float uniformScale = 1.0f;
+    // Order the scale/rotate/translate steps are applied in.
+    enum class XformOrder : int { SRT, STR, RST, RTS, TSR, TRS };
+    // Order of the per-axis rotations (XYZ = X first).
+    enum class RotateOrder : int { XYZ, XZY, YXZ, YZX, ZXY, ZYX };
+
+    // Parameter indices, in layout order. Rotate is in degrees; scale and
+    // rotation happen about Pivot.
+    enum Param : size_t { Order, RotOrder, Translate, Rotate, Scale, UniformScale, Pivot };
+
+    // All of the parameters as one matrix.
+    Mat4 matrix() const;
 
     Geometry cook(const CookContext&,
                   const std::vector<std::shared_ptr<const Geometry>>& inputs) const override;
-};
\ No newline at end of file
+};
@@ -0,0 +1,75 @@
+#include "core/ops/WaveSop.h"
+
+#include <cmath>
+#include <numbers>
+
+namespace
+{
+    const ParamLayout& layout()
+    {
+        static const ParamLayout params = {
+            {.name = "amplitude", .label = "Amplitude", .type = ParamType::Float, .def = {0.1f},
+             .min = -1e6f, .max = 1e6f},
+            {.name = "wavelength", .label = "Wavelength", .type = ParamType::Float, .def = {1},
+             .min = 0.001f, .max = 1e6f},
+            {.name = "speed", .label = "Speed", .type = ParamType::Float, .def = {0.5f}, .min = -1e6f, .max = 1e6f},
+            {.name = "direction", .label = "Direction", .type = ParamType::Vec3, .def = {1, 0, 0},
+             .min = -1, .max = 1},
+        };
+        return params;
+    }
+}
+
+WaveSop::WaveSop(NodeId id) : Node(id, layout())
+{
+    setName("wave1");
+}
+
+bool WaveSop::isTimeDependent() const
+{
+    return params().getFloat(Speed) != 0.0f;
+}
+
+Geometry WaveSop::cook(const CookContext& ctx,
+                       const std::vector<std::shared_ptr<const Geometry>>& inputs) const
+{
+    Geometry out;
+    if (inputs.empty() || !inputs[0]) return out;
+
+    // Only P.y gets new storage; X, Z and everything else stay shared.
+    const Geometry& in = *inputs[0];
+    out = in;
+    if (ctx.cancelled()) return out;
+
+    const float amplitude = params().getFloat(Amplitude);
+    const double k = 2.0 * std::numbers::pi / double(params().getFloat(Wavelength));
+
+    Vec3 dir = params().getVec3(Direction);
+    const float len = std::sqrt(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
+    if (len > 0.0f) dir = {dir.x / len, dir.y / len, dir.z / len};
+    else dir = {1.0f, 0.0f, 0.0f};
+
+    // Reduce the time term in double so late frames keep float precision.
+    const double travelled = isTimeDependent() ? double(params().getFloat(Speed)) * ctx.time() : 0.0;
+    const float phase = float(std::fmod(k * travelled, 2.0 * std::numbers::pi));
+    const float kf = float(k);
+
+    const Attribute& src = in.P();
+    const float* sx = src.floats(0);
+    const float* sy = src.floats(1);
+    const float* sz = src.floats(2);
+    float* dy = out.P().overwriteFloats(1);
+
+    constexpr size_t kGrain = 1 << 16;
+    ctx.parallelFor(src.size(), kGrain, [&](size_t begin, size_t end)
+    {
+        if (ctx.cancelled()) return;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const float d = sx[i] * dir.x + sy[i] * dir.y + sz[i] * dir.z;
+            dy[i] = sy[i] + amplitude * std::sin(kf * d - phase);
+        }
+    });
+
+    return out;
+}
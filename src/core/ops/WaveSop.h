@@ -0,0 +1,21 @@
+#pragma once
+#include "core/graph/Node.h"
+
+// Travelling sine wave: displaces points along +Y by
+// amplitude * sin(2pi * (dot(P, direction) - speed * time) / wavelength).
+// Time dependent unless speed is 0.
+class WaveSop final : public Node
+{
+public:
+    explicit WaveSop(NodeId id);
+
+    const char* typeName() const override { return "Wave"; }
+
+    // Parameter indices, in layout order. Speed is in units per second.
+    enum Param : size_t { Amplitude, Wavelength, Speed, Direction };
+
+    bool isTimeDependent() const override;
+
+    Geometry cook(const CookContext&,
+                  const std::vector<std::shared_ptr<const Geometry>>& inputs) const override;
+};
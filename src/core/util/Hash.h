@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Stable 64-bit content hash (FNV-1a over little-endian bytes + a final mix).
+// Values must not depend on the process, pointer values or platform, since
+// they key cached geometry.
+class Hasher
+{
+public:
+    Hasher& addBytes(const void* data, size_t n)
+    {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n; ++i)
+        {
+            m_h ^= p[i];
+            m_h *= 0x100000001b3ull;
+        }
+        return *this;
+    }
+
+    Hasher& add(uint64_t v)
+    {
+        unsigned char b[8];
+        for (int i = 0; i < 8; ++i) b[i] = (unsigned char)(v >> (8 * i));
+        return addBytes(b, sizeof(b));
+    }
+
+    Hasher& add(int64_t v) { return add(uint64_t(v)); }
+    Hasher& add(uint32_t v) { return add(uint64_t(v)); }
+    Hasher& add(int v) { return add(uint64_t(int64_t(v))); }
+
+    Hasher& add(float v)
+    {
+        if (v == 0.0f) v = 0.0f; // -0 and +0 hash the same
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return add(bits);
+    }
+
+    Hasher& add(std::string_view s)
+    {
+        add(uint64_t(s.size()));
+        return addBytes(s.data(), s.size());
+    }
+
+    Hasher& add(const char* s) { return add(std::string_view(s)); }
+
+    uint64_t value() const
+    {
+        // splitmix64 finalizer: FNV alone mixes the high bits poorly
+        uint64_t z = m_h;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t m_h = 0xcbf29ce484222325ull;
+};
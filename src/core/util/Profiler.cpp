@@ -0,0 +1,177 @@
+#include "core/util/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+static_assert(sizeof(ProfileEvent) % sizeof(uint64_t) == 0, "events are stored as whole words");
+static_assert(std::is_trivially_copyable_v<ProfileEvent>);
+
+namespace
+{
+    int64_t steadyNs()
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    const char* kindName(ProfileKind k)
+    {
+        switch (k)
+        {
+            case ProfileKind::Cook: return "cook";
+            case ProfileKind::CacheHit: return "cache";
+            case ProfileKind::Evaluate: return "evaluate";
+            case ProfileKind::Upload: return "upload";
+            case ProfileKind::Draw: return "draw";
+        }
+        return "?";
+    }
+
+    void writeJsonString(std::ostream& os, const char* s)
+    {
+        os << '"';
+        for (; *s; ++s)
+        {
+            const unsigned char c = static_cast<unsigned char>(*s);
+            if (c == '"' || c == '\\') os << '\\' << char(c);
+            else if (c < 0x20)
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                os << buf;
+            }
+            else os << char(c);
+        }
+        os << '"';
+    }
+}
+
+void ProfileEvent::setName(std::string_view n)
+{
+    const size_t len = std::min(n.size(), sizeof(name) - 1);
+    std::memcpy(name, n.data(), len);
+    name[len] = '\0';
+}
+
+Profiler::Profiler(size_t capacity)
+    : m_epochNs(steadyNs())
+{
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+    m_slots = std::make_unique<Slot[]>(cap);
+    m_mask = cap - 1;
+}
+
+Profiler& Profiler::instance()
+{
+    static Profiler p;
+    return p;
+}
+
+int64_t Profiler::nowNs() const
+{
+    return steadyNs() - m_epochNs;
+}
+
+uint32_t Profiler::threadIndex()
+{
+    static std::atomic<uint32_t> next{1};
+    thread_local const uint32_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+void Profiler::record(ProfileEvent e)
+{
+    if (!enabled()) return;
+    e.thread = threadIndex();
+
+    const uint64_t idx = m_head.fetch_add(1, std::memory_order_relaxed);
+    Slot& s = m_slots[idx & m_mask];
+    s.seq.store(2 * idx + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    uint64_t words[kWords];
+    std::memcpy(words, &e, sizeof(e));
+    for (size_t w = 0; w < kWords; ++w)
+        s.words[w].store(words[w], std::memory_order_relaxed);
+    s.seq.store(2 * idx + 2, std::memory_order_release);
+}
+
+void Profiler::clear()
+{
+    // Writers may be mid-record; just hide everything before the current head.
+    m_floor.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+std::vector<ProfileEvent> Profiler::snapshot() const
+{
+    const uint64_t head = m_head.load(std::memory_order_acquire);
+    const uint64_t cap = m_mask + 1;
+    const uint64_t begin = std::max(head > cap ? head - cap : 0,
+                                    m_floor.load(std::memory_order_acquire));
+
+    std::vector<ProfileEvent> out;
+    out.reserve(size_t(head - begin));
+    for (uint64_t idx = begin; idx < head; ++idx)
+    {
+        const Slot& s = m_slots[idx & m_mask];
+        const uint64_t before = s.seq.load(std::memory_order_acquire);
+        if (before != 2 * idx + 2) continue; // still being written, or already lapped
+
+        uint64_t words[kWords];
+        for (size_t w = 0; w < kWords; ++w)
+            words[w] = s.words[w].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) != before) continue; // torn
+
+        ProfileEvent& e = out.emplace_back();
+        std::memcpy(&e, words, sizeof(e));
+    }
+    return out;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const
+{
+    std::ofstream os(path, std::ios::binary);
+    if (!os) return false;
+
+    const auto events = snapshot();
+
+    char buf[160];
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const ProfileEvent& e = events[i];
+        os << "{\"name\":";
+        writeJsonString(os, e.name[0] ? e.name : kindName(e.kind));
+        std::snprintf(buf, sizeof(buf),
+                      ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,",
+                      kindName(e.kind), e.thread, double(e.startNs) / 1000.0, double(e.durationNs) / 1000.0);
+        os << buf;
+        std::snprintf(buf, sizeof(buf), "\"args\":{\"node\":%llu,\"eval\":%llu,\"bytes\":%llu}}",
+                      (unsigned long long)e.node, (unsigned long long)e.evalId, (unsigned long long)e.bytes);
+        os << buf << (i + 1 < events.size() ? ",\n" : "\n");
+    }
+    os << "]}\n";
+    return bool(os);
+}
+
+ProfileScope::ProfileScope(ProfileKind kind, std::string_view name, Profiler& p)
+    : m_profiler(p)
+    , m_active(p.enabled())
+{
+    if (!m_active) return;
+    m_event.kind = kind;
+    m_event.setName(name);
+    m_event.startNs = p.nowNs();
+}
+
+ProfileScope::~ProfileScope()
+{
+    if (!m_active) return;
+    m_event.durationNs = m_profiler.nowNs() - m_event.startNs;
+    m_profiler.record(m_event);
+}
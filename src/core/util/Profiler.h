@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ProfileKind : uint8_t
+{
+    Cook,      // a node's cook() ran
+    CacheHit,  // a node's result came from the store
+    Evaluate,  // one whole Cooker::evaluate
+    Upload,    // viewport: geometry -> GPU buffers
+    Draw       // viewport: draw submission for one frame
+};
+
+struct ProfileEvent
+{
+    ProfileKind kind = ProfileKind::Cook;
+    uint32_t thread = 0;     // small per-thread index, see Profiler::threadIndex()
+    uint64_t evalId = 0;     // groups the node events of one evaluate (0 = none)
+    uint64_t node = 0;       // NodeId, 0 for viewport events
+    int64_t startNs = 0;     // since the profiler was created
+    int64_t durationNs = 0;
+    uint64_t bytes = 0;      // newly produced (cook) / held (hit) / uploaded
+    char name[40] = {};      // truncated copy, so events outlive renamed or deleted nodes
+
+    void setName(std::string_view n);
+};
+
+// Fixed-size ring of the most recent events. Recording is lock-free and safe
+// from any thread (pool workers record their own cooks); readers take a
+// snapshot and skip slots that are mid-write. Old events are overwritten.
+class Profiler
+{
+public:
+    explicit Profiler(size_t capacity = 1 << 14); // rounded up to a power of two
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // The one the cooker and viewport record into.
+    static Profiler& instance();
+
+    // Off until something reads the events (the HUD, a trace capture, batch
+    // --timing): each holds a user while it needs them. Disabled, scopes and
+    // the cooker's byte accounting cost next to nothing.
+    bool enabled() const { return m_users.load(std::memory_order_relaxed) > 0; }
+    void addUser() { m_users.fetch_add(1, std::memory_order_relaxed); }
+    void removeUser() { m_users.fetch_sub(1, std::memory_order_relaxed); }
+
+    int64_t nowNs() const;
+    uint64_t newEvalId() { return m_nextEvalId.fetch_add(1, std::memory_order_relaxed); }
+
+    void record(ProfileEvent e); // fills in thread
+    void clear();
+
+    // Oldest first.
+    std::vector<ProfileEvent> snapshot() const;
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto). False if the file
+    // couldn't be written.
+    bool writeChromeTrace(const std::string& path) const;
+
+    static uint32_t threadIndex();
+
+private:
+    // Per-slot seqlock: odd while being written, 2 * (index + 1) once complete.
+    // The payload is kept as relaxed atomic words so a racing read is merely
+    // stale (and discarded), never undefined.
+    static constexpr size_t kWords = sizeof(ProfileEvent) / sizeof(uint64_t);
+    struct Slot
+    {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<uint64_t> words[kWords] = {};
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+    std::atomic<uint64_t> m_head{0};
+    std::atomic<uint64_t> m_floor{0}; // clear() point: older events are hidden
+    std::atomic<uint64_t> m_nextEvalId{1};
+    std::atomic<int> m_users{0};
+    const int64_t m_epochNs;
+};
+
+// Times a scope into the profiler; fill in the rest of event() before it ends.
+class ProfileScope
+{
+public:
+    ProfileScope(ProfileKind kind, std::string_view name, Profiler& p = Profiler::instance());
+    ~ProfileScope();
+
+    ProfileEvent& event() { return m_event; }
+
+private:
+    Profiler& m_profiler;
+    ProfileEvent m_event;
+    bool m_active;
+};
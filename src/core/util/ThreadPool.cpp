@@ -0,0 +1,156 @@
+#include "core/util/ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Which pool/worker the current thread belongs to (external threads: -1).
+    thread_local const ThreadPool* t_pool = nullptr;
+    thread_local int t_worker = -1;
+}
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    m_queues.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    m_threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        m_threads.emplace_back([this, i]() { workerLoop(int(i)); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads) t.join();
+}
+
+int ThreadPool::currentWorker() const
+{
+    return (t_pool == this) ? t_worker : -1;
+}
+
+void ThreadPool::push(Task task)
+{
+    // Workers push onto their own deque; outside threads spread round-robin.
+    int q = currentWorker();
+    if (q < 0) q = int(m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[q]->m);
+        m_queues[q]->tasks.push_back(std::move(task));
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+
+    // Take the sleep mutex so a worker between its predicate check and wait() can't miss this.
+    { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+    m_wake.notify_one();
+}
+
+bool ThreadPool::tryRunOne(int self)
+{
+    Task task;
+    const int n = int(m_queues.size());
+
+    // own queue first, newest task
+    if (self >= 0)
+    {
+        std::lock_guard<std::mutex> lock(m_queues[self]->m);
+        auto& dq = m_queues[self]->tasks;
+        if (!dq.empty())
+        {
+            task = std::move(dq.back());
+            dq.pop_back();
+        }
+    }
+
+    // steal oldest from the others
+    if (!task)
+    {
+        const int start = (self >= 0) ? self + 1 : 0;
+        for (int k = 0; k < n && !task; ++k)
+        {
+            Queue& victim = *m_queues[(start + k) % n];
+            std::lock_guard<std::mutex> lock(victim.m);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+    }
+
+    if (!task) return false;
+
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(int index)
+{
+    t_pool = this;
+    t_worker = index;
+
+    for (;;)
+    {
+        if (tryRunOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this]() { return m_stop || m_queued.load(std::memory_order_acquire) > 0; });
+        if (m_stop && m_queued.load() == 0) return;
+    }
+}
+
+void ThreadPool::TaskGroup::run(Task task)
+{
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    m_pool.push([this, task = std::move(task)]()
+    {
+        task();
+        m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    });
+}
+
+void ThreadPool::TaskGroup::wait()
+{
+    const int self = m_pool.currentWorker();
+    while (m_pending.load(std::memory_order_acquire) > 0)
+    {
+        // help instead of blocking; our own tasks may be sitting in a queue
+        if (!m_pool.tryRunOne(self))
+            std::this_thread::yield();
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, size_t grain, const std::function<void(size_t, size_t)>& fn)
+{
+    if (n == 0) return;
+    if (grain == 0) grain = 1;
+
+    if (n <= grain)
+    {
+        fn(0, n);
+        return;
+    }
+
+    TaskGroup group(*this);
+
+    // keep the first chunk for the calling thread
+    for (size_t begin = grain; begin < n; begin += grain)
+    {
+        const size_t end = std::min(n, begin + grain);
+        group.run([&fn, begin, end]() { fn(begin, end); });
+    }
+    fn(0, grain);
+
+    group.wait();
+}
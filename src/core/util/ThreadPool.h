@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work-stealing pool.
+// Each worker owns a deque: it pops its own work LIFO (cache-warm) and steals
+// from the other workers FIFO when it runs dry. Threads that block on a
+// TaskGroup keep executing queued tasks while they wait, so nested
+// parallelFor calls (a cook task splitting its own loop) cannot deadlock.
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    // 0 = std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return unsigned(m_threads.size()); }
+
+    // Counts outstanding tasks; wait() helps run queued work until it hits zero.
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(ThreadPool& pool) : m_pool(pool) {}
+        ~TaskGroup() { wait(); }
+
+        void run(Task task);
+        void wait();
+
+    private:
+        ThreadPool& m_pool;
+        std::atomic<size_t> m_pending{0};
+    };
+
+    // Calls fn(begin, end) over [0, n) in chunks of at most `grain`.
+    // The calling thread participates; returns once every chunk has run.
+    void parallelFor(size_t n, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    struct Queue
+    {
+        std::mutex m;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues; // one per worker
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<size_t> m_queued{0};
+    std::atomic<unsigned> m_nextQueue{0};
+    bool m_stop = false;
+
+    void push(Task task);
+    bool tryRunOne(int self);
+    void workerLoop(int index);
+    int currentWorker() const;
+};
@@ -3,10 +3,19 @@
 //
 
 #include <QApplication>
+#include <QSurfaceFormat>
 #include "MainWindow.h"
 
 int main(int argc, char** argv)
 {
+    // The viewport draws with a 3.3 core-profile pipeline (also what macOS
+    // and Mesa llvmpipe hand out). Must be set before the app is created.
+    QSurfaceFormat fmt;
+    fmt.setVersion(3, 3);
+    fmt.setProfile(QSurfaceFormat::CoreProfile);
+    fmt.setDepthBufferSize(24);
+    QSurfaceFormat::setDefaultFormat(fmt);
+
     QApplication app(argc, argv);
 
     MainWindow w;
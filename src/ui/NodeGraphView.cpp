@@ -3,6 +3,8 @@
 #include <QKeyEvent>
 #include <QWheelEvent>
 
+#include <algorithm>
+
 
 
 NodeGraphView::NodeGraphView(QWidget* parent)
@@ -29,11 +31,17 @@ void NodeGraphView::setGraph(Graph* g)
 int NodeGraphView::inputCountForNode(const Node* n) const
 {
   if (!n) return 0;
-  // MVP SOP arity rules
-  const std::string t = n->typeName();
-  if (t == "Grid") return 0;
-  if (t == "Merge") return 2;      // start with 2 inputs
-  return 1;                        // Transform, Null
+  const int maxInputs = n->maxInputs();
+  if (maxInputs >= 0) return maxInputs;
+
+  // unlimited (Merge): always keep one free socket past the highest wired one
+  int highest = -1;
+  if (m_graph)
+  {
+    const auto slots = m_graph->inputSlots(n->id());
+    if (!slots.empty()) highest = slots.back().first;
+  }
+  return std::max(2, highest + 2);
 }
 
 void NodeGraphView::rebuildFromGraph()
@@ -55,14 +63,24 @@ void NodeGraphView::rebuildFromGraph()
     auto* item = new NodeItem(id, QString::fromStdString(n->name()), inputs);
     m_scene.addItem(item);
 
-    // Simple grid layout if no positions stored yet
-    const int col = i % 3;
-    const int row = i / 3;
-    item->setPos(col * 220, row * 140);
+    // Saved position, else a simple grid layout (kept on the node so it's saved too)
+    if (n->hasUiPos())
+    {
+      item->setPos(n->uiX(), n->uiY());
+    }
+    else
+    {
+      const int col = i % 3;
+      const int row = i / 3;
+      item->setPos(col * 220, row * 140);
+      m_graph->get(id)->setUiPos(float(item->x()), float(item->y()));
+    }
 
     connect(item, &NodeItem::clicked, this, &NodeGraphView::onNodeClicked);
     connect(item, &NodeItem::doubleClicked, this, &NodeGraphView::onNodeDoubleClicked);
-    connect(item, &NodeItem::moved, this, [this](NodeId){
+    connect(item, &NodeItem::moved, this, [this, item](NodeId movedId){
+      if (Node* moved = m_graph ? m_graph->get(movedId) : nullptr)
+        moved->setUiPos(float(item->x()), float(item->y()));
       updateAllConnectionEndpoints();
     });
 
@@ -87,16 +105,15 @@ void NodeGraphView::rebuildConnections()
     const Node* dstNode = m_graph->get(dst);
     if (!dstNode) continue;
 
-    const int inputs = inputCountForNode(dstNode);
-    auto itConn = m_graph->inputsOf(dst); // ordered sources by input index ascending, but we need actual indices
-    // We don't have indices from Graph::inputsOf, so we re-walk Graph internals would be needed.
-    // MVP workaround: treat ordered list as inputs 0..N-1.
-    for (int inputIndex = 0; inputIndex < (int)itConn.size() && inputIndex < inputs; ++inputIndex)
+    auto* dstItem = m_nodeItems[dst];
+    if (!dstItem) continue;
+    dstItem->setInputCount(inputCountForNode(dstNode));
+
+    for (const auto& [inputIndex, src] : m_graph->inputSlots(dst))
     {
-      NodeId src = itConn[(size_t)inputIndex];
+      if (inputIndex >= dstItem->inputCount()) continue;
       auto* srcItem = m_nodeItems[src];
-      auto* dstItem = m_nodeItems[dst];
-      if (!srcItem || !dstItem) continue;
+      if (!srcItem) continue;
 
       auto* conn = new ConnectionItem();
       m_scene.addItem(conn);
@@ -123,11 +140,10 @@ void NodeGraphView::updateAllConnectionEndpoints()
     auto* dstItem = m_nodeItems[key.dst];
     if (!dstItem) continue;
 
-    const auto inputs = m_graph->inputsOf(key.dst);
-    if (key.input < 0 || key.input >= (int)inputs.size()) continue;
-
-    const NodeId srcId = inputs[(size_t)key.input];
-    auto* srcItem = m_nodeItems[srcId];
+    NodeId srcId = 0;
+    for (const auto& [inputIndex, src] : m_graph->inputSlots(key.dst))
+      if (inputIndex == key.input) srcId = src;
+    auto* srcItem = srcId ? m_nodeItems[srcId] : nullptr;
     if (!srcItem) continue;
 
     conn->setEndpoints(srcItem->outputSocketScenePos(),
@@ -219,10 +235,11 @@ void NodeGraphView::endWireDrag(const QPointF& scenePos)
       const int inputIndex = target->hitInputSocket(scenePos);
       if (inputIndex >= 0)
       {
+        emit graphAboutToChange();
         m_graph->disconnect(target->nodeId(), inputIndex);
         m_graph->connect(m_dragSrcNode, target->nodeId(), inputIndex);
         rebuildConnections();
-        emit graphChanged();
+        emit graphChanged(target->nodeId());
         break;
       }
     }
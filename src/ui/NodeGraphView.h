@@ -27,7 +27,8 @@ public:
 signals:
     void nodeSelected(NodeId id);
     void displayNodeRequested(NodeId id);
-    void graphChanged(); // connect/disconnect
+    void graphAboutToChange();     // emitted before the model graph is edited
+    void graphChanged(NodeId dst); // connect/disconnect on dst's inputs
 
 protected:
     void mousePressEvent(QMouseEvent* e) override;
@@ -2,6 +2,8 @@
 #include <QPainter>
 #include <QGraphicsSceneMouseEvent>
 
+#include <algorithm>
+
 NodeItem::NodeItem(NodeId id, QString title, int inputCount, QGraphicsItem* parent)
   : QGraphicsObject(parent)
   , m_id(id)
@@ -12,6 +14,18 @@ NodeItem::NodeItem(NodeId id, QString title, int inputCount, QGraphicsItem* pare
   setAcceptHoverEvents(true);
   setFlag(QGraphicsItem::ItemIsMovable, true);
   setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
+  setInputCount(inputCount);
+}
+
+void NodeItem::setInputCount(int n)
+{
+  const qreal height = std::max<qreal>(70, 36 + 16 * n);
+  if (n == m_inputs && height == m_rect.height()) return;
+
+  prepareGeometryChange();
+  m_inputs = n;
+  m_rect.setHeight(height);
+  update();
 }
 
 QRectF NodeItem::boundingRect() const { return m_rect.adjusted(-2, -2, 2, 2); }
@@ -13,6 +13,7 @@ class NodeItem final : public QGraphicsObject
 
     NodeId nodeId() const { return m_id; }
     int inputCount() const { return m_inputs; }
+    void setInputCount(int n); // grows the body so sockets stay spaced out
 
     QRectF boundingRect() const override;
     void paint(QPainter* p, const QStyleOptionGraphicsItem* opt, QWidget* w) override;